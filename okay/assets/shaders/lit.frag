@@ -10,8 +10,13 @@ in mat3 v_worldToTangent;
 
 out vec4 FragColor;
 
-/* Camera */
-uniform vec3 u_cameraPosition;
+/* Camera, shared by every built-in shader (see FrameUniforms) */
+layout(std140) uniform u_view {
+    mat4 u_projectionMatrix;
+    mat4 u_viewMatrix;
+    vec4 u_cameraPosition;   // w unused
+    vec4 u_cameraDirection;  // w unused
+};
 
 /* Material */
 uniform float u_ambient;     // e.g. 0.05
@@ -42,9 +47,10 @@ struct Light {
     vec4 extra;      // point: x = radius, spot: x = radius, y = angleRad
 };
 
-layout(std140) uniform u_lights {
-    vec4 meta;       // meta.x = lightCount
-    Light lights[16];
+/* Frame data, shared by every built-in shader (see FrameUniforms) */
+layout(std140) uniform u_frame {
+    vec4 u_frameMeta;  // x = lightCount, y = time in ms
+    Light u_lights[16];
 };
 
 /***************/
@@ -428,52 +434,52 @@ vec3 evaluateDisney(vec3 N, vec3 wi, vec3 wm, vec3 wo, vec3 baseColor) {
 
 void main() {
     vec3 N = safeNormalize(v_worldNormal); // normal vector
-    vec3 V = safeNormalize(u_cameraPosition - v_worldPos); // view vector
+    vec3 V = safeNormalize(u_cameraPosition.xyz - v_worldPos); // view vector
 
     
     vec4 texAlbedo = texture(u_albedo, v_uv);
     vec3 baseColor = mon2lin(texAlbedo.rgb) * v_color;
     vec3 colorOut = u_ambient * baseColor;
 
-    int count = int(meta.x + 0.5);
+    int count = int(u_frameMeta.x + 0.5);
     int maxLights = min(count, 16);
 
     for (int i = 0; i < 16; ++i) {
         if (i >= maxLights) break;
 
-        vec3 Lrgb = lights[i].color.rgb;
-        float intensity = lights[i].color.w;
+        vec3 Lrgb = u_lights[i].color.rgb;
+        float intensity = u_lights[i].color.w;
 
-        int type = int(floor(lights[i].posType.w + 0.5)); // 0=dir, 1=point, 2=spot
+        int type = int(floor(u_lights[i].posType.w + 0.5)); // 0=dir, 1=point, 2=spot
 
         vec3 L = vec3(0.0); // fragment -> light
         float att = 1.0; // attenuation
 
         if (type == 0) {
             // Directional: direction.xyz is the direction light shines (world)
-            vec3 dir = safeNormalize(lights[i].direction.xyz);
+            vec3 dir = safeNormalize(u_lights[i].direction.xyz);
             // Fragment -> light is opposite incoming direction
             L = safeNormalize(-dir);
         } else if (type == 1) {
             // Point
-            vec3 toL = lights[i].posType.xyz - v_worldPos;
+            vec3 toL = u_lights[i].posType.xyz - v_worldPos;
             float dist2 = dot(toL, toL);
             float dist = sqrt(max(dist2, 1e-8));
             L = toL / dist;
 
-            float radius = lights[i].extra.x;
+            float radius = u_lights[i].extra.x;
             att = radiusAttenuation(dist, radius);
         } else if (type == 2) {
             // Spot
-            vec3 toL = lights[i].posType.xyz - v_worldPos;
+            vec3 toL = u_lights[i].posType.xyz - v_worldPos;
             float dist2 = dot(toL, toL);
             float dist = sqrt(max(dist2, 1e-8));
             L = toL / dist;
 
-            float radius = lights[i].extra.x;
-            float angleRad = lights[i].extra.y;
+            float radius = u_lights[i].extra.x;
+            float angleRad = u_lights[i].extra.y;
 
-            float cone = spotConeFactor(L, lights[i].direction.xyz, angleRad);
+            float cone = spotConeFactor(L, u_lights[i].direction.xyz, angleRad);
             att = radiusAttenuation(dist, radius) * cone;
 
             // If cone factor is 0, skip work
@@ -6,17 +6,28 @@ layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec4 a_color;
 layout(location = 3) in vec2 a_uv;
 
-/* Transforms */
-uniform mat4 u_modelMatrix;
-uniform mat4 u_viewMatrix;
-uniform mat4 u_projectionMatrix;
+/* Per object data, indexed by gl_InstanceID (see InstanceBuffer) */
+struct InstanceData {
+    mat4 model;
+    mat3 normalMatrix;
+    vec4 tint;
+};
+
+layout(std140) uniform u_instances {
+    InstanceData u_instance[128];
+};
+
+/* Camera, shared by every built-in shader (see FrameUniforms) */
+layout(std140) uniform u_view {
+    mat4 u_projectionMatrix;
+    mat4 u_viewMatrix;
+    vec4 u_cameraPosition;   // w unused
+    vec4 u_cameraDirection;  // w unused
+};
 
 /* Material */
 uniform vec3 u_color;
 
-/* Camera */
-uniform vec3 u_cameraPosition;
-
 out vec3 v_color;
 out vec3 v_worldPos;
 out vec3 v_worldNormal;
@@ -24,14 +35,14 @@ out vec2 v_uv;
 out mat3 v_worldToTangent;
 
 void main() {
-    vec4 worldPos4 = u_modelMatrix * vec4(a_pos, 1.0f);
+    InstanceData instance = u_instance[gl_InstanceID];
+    vec4 worldPos4 = instance.model * vec4(a_pos, 1.0f);
     v_worldPos = worldPos4.xyz;
 
-    mat3 normalMatrix = transpose(inverse(mat3(u_modelMatrix)));
-    v_worldNormal = normalize(normalMatrix * a_normal);
+    v_worldNormal = normalize(instance.normalMatrix * a_normal);
 
     v_uv = a_uv;
-    v_color = u_color * a_color.rgb;
+    v_color = u_color * a_color.rgb * instance.tint.rgb;
 
     vec3 ref = vec3(0.0f, 1.0f, 0.0f);
     if (abs(dot(v_worldNormal, ref)) > 0.999) ref = vec3(1.0f, 0.0f, 0.0f);
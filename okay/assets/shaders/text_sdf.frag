@@ -1,6 +1,7 @@
 #version 300 es
 precision highp float;
 
+in vec4 v_color;
 in vec2 v_uv;
 in vec2 v_clipSpaceUV;
 
@@ -8,7 +9,6 @@ layout(location = 0) out vec4 FragColor;
 
 uniform sampler2D u_albedo;
 uniform sampler2D u_clipMask;
-uniform vec4 u_color;
 
 void main() {
     float sd = texture(u_albedo, v_uv).a;
@@ -18,7 +18,7 @@ void main() {
     float screenPxRange = max(0.5 * dot(unitRange, 1.0 / fwidth(v_uv)), 1.0);
 
     float alpha = clamp((sd - 0.5) * screenPxRange + 0.5, 0.0, 1.0);
-    alpha *= u_color.a;
+    alpha *= v_color.a;
 
-    FragColor = vec4(u_color.rgb, alpha);
+    FragColor = vec4(v_color.rgb, alpha);
 }
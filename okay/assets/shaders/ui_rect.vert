@@ -9,11 +9,17 @@ layout(location = 2) in vec4 a_color;
 layout(location = 3) in vec2 a_uv;
 
 uniform mat4 u_modelMatrix;
-uniform mat4 u_viewMatrix;
-uniform mat4 u_projectionMatrix;
-uniform vec3 u_cameraPosition;
-uniform vec3 u_cameraDirection;
+
+// camera, shared by every built-in shader (see FrameUniforms)
+layout(std140) uniform u_view {
+    mat4 u_projectionMatrix;
+    mat4 u_viewMatrix;
+    vec4 u_cameraPosition;   // w unused
+    vec4 u_cameraDirection;  // w unused
+};
+
 uniform vec4 u_color;
+uniform vec4 u_tint;  // per object, set with the model matrix
 
 out vec4 v_color;
 out vec3 v_normal;
@@ -28,10 +34,10 @@ void main() {
    vec4 pos = mvp * vec4(a_pos, 1.0f);
    gl_Position = pos;
 
-   v_color = u_color;
+   v_color = u_color * u_tint;
    v_normal = a_normal;
    v_position = a_pos;
    v_uv = a_uv;
-   v_cameraPosition = u_cameraPosition;
-   v_cameraDirection = u_cameraDirection;
+   v_cameraPosition = u_cameraPosition.xyz;
+   v_cameraDirection = u_cameraDirection.xyz;
 }
\ No newline at end of file
@@ -8,11 +8,25 @@ layout(location = 1) in vec3 a_normal;
 layout(location = 2) in vec4 a_color;
 layout(location = 3) in vec2 a_uv;
 
-uniform mat4 u_modelMatrix;
-uniform mat4 u_viewMatrix;
-uniform mat4 u_projectionMatrix;
-uniform vec3 u_cameraPosition;
-uniform vec3 u_cameraDirection;
+// per object data, indexed by gl_InstanceID (see InstanceBuffer)
+struct InstanceData {
+    mat4 model;
+    mat3 normalMatrix;
+    vec4 tint;
+};
+
+layout(std140) uniform u_instances {
+    InstanceData u_instance[128];
+};
+
+// camera, shared by every built-in shader (see FrameUniforms)
+layout(std140) uniform u_view {
+    mat4 u_projectionMatrix;
+    mat4 u_viewMatrix;
+    vec4 u_cameraPosition;   // w unused
+    vec4 u_cameraDirection;  // w unused
+};
+
 uniform vec3 u_color;
 
 out vec3 v_color;
@@ -23,14 +37,16 @@ out vec3 v_cameraPosition;
 out vec3 v_cameraDirection;
 
 void main() {
-    mat4 mvp = u_projectionMatrix * u_viewMatrix * u_modelMatrix;
+    InstanceData instance = u_instance[gl_InstanceID];
+    mat4 mvp = u_projectionMatrix * u_viewMatrix * instance.model;
     vec4 pos = mvp * vec4(a_pos, 1.0f);
     gl_Position = pos;
 
-    v_color = u_color;
+    // vertex colors carry the tint of static batches, the same as in lit.vert
+    v_color = u_color * a_color.rgb * instance.tint.rgb;
     v_normal = a_normal;
     v_position = a_pos;
     v_uv = a_uv;
-    v_cameraPosition = u_cameraPosition;
-    v_cameraDirection = u_cameraDirection;
+    v_cameraPosition = u_cameraPosition.xyz;
+    v_cameraDirection = u_cameraDirection.xyz;
 }
@@ -205,6 +205,7 @@ class AssetManager : public System<SystemScope::ENGINE> {
 
     template <typename T, typename AssetIO = DefaultAssetIO, typename LoadOptions>
     Result<Asset<T>> loadAssetSync(const Load<T, AssetIO>& load, const LoadOptions& options) {
+        AllocationScope allocations(MemoryTag::ASSETS);
         auto& store = CachedAssetStore<T, LoadOptions>::instance();
         Option<Asset<T>> assetOpt = store.getCachedAsset(load.assetPath, options);
         if (assetOpt.isSome()) {
@@ -16,6 +16,9 @@ struct MeshRendererComponent {
     Mesh mesh{Mesh::none()};
     MaterialHandle material{MaterialHandle::none()};
     std::uint8_t renderLayer{0};
+    glm::vec4 tint{1.0f};
+    // never moves or changes, baked together with other static meshes of its material
+    bool isStatic{false};
     RenderEntity renderEntity{};
 
     MeshRendererComponent() {}
@@ -51,6 +51,7 @@ class ECS : public EntityComponentStore, public System<SystemScope::LEVEL> {
         value_type operator*() const {
             ObjectPoolHandle handle{_index, _ecs->_entityMetas.generationAt(_index)};
             ECSEntity entity{_ecs, handle};
+            Engine.stats.add(Stat::QUERY_ITERATIONS);
             return Query::createItem(std::move(entity), *_ecs);
         }
 
@@ -158,6 +159,7 @@ class ECS : public EntityComponentStore, public System<SystemScope::LEVEL> {
     }
 
     void preTick() override {
+        Engine.stats.set(Stat::ENTITY_COUNT, static_cast<FrameStats::Value>(getEntityCount()));
         for (auto& system : _systems) {
             system->preTick(*this);
         }
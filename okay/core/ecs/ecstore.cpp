@@ -8,13 +8,17 @@ ECSEntity EntityComponentStore::createEntity() {
     EntityMeta meta{};
     meta.id = _nextEntityID++;
 
-    ObjectPoolHandle handle = _entityMetas.emplace(meta);
+    ObjectPoolHandle handle;
+    {
+        AllocationScope allocations(MemoryTag::ECS);
+        handle = _entityMetas.emplace(meta);
 
-    const std::size_t desiredCapacity =
-        _reservedEntityCount * static_cast<std::size_t>(POOL_GROWTH_FACTOR);
+        const std::size_t desiredCapacity =
+            _reservedEntityCount * static_cast<std::size_t>(POOL_GROWTH_FACTOR);
 
-    for (auto& pool : _componentPools) {
-        pool->reserve(desiredCapacity);
+        for (auto& pool : _componentPools) {
+            pool->reserve(desiredCapacity);
+        }
     }
 
     ECSEntity entity(this, handle);
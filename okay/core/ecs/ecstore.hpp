@@ -334,8 +334,12 @@ void EntityComponentStore::addComponent(ECSEntity& entity, Args&&... args) {
         return;
     }
 
-    auto& pool = getPool<T>();
-    pool.emplaceAt(entity._handle.index, std::forward<Args>(args)...);
+    {
+        AllocationScope allocations(MemoryTag::ECS);
+        auto& pool = getPool<T>();
+        pool.emplaceAt(entity._handle.index, std::forward<Args>(args)...);
+    }
+
     EntityMeta& meta = getEntityMeta(entity);
     EntityMeta oldMeta = meta;
     meta.componentMask.set(componentID.value(), true);
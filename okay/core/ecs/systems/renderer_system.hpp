@@ -10,6 +10,8 @@
 #include <okay/core/renderer/render_world.hpp>
 #include <okay/core/renderer/renderer.hpp>
 
+#include <vector>
+
 namespace okay {
 
 class RendererSystem : public ECSSystem<query::Get<TransformComponent, MeshRendererComponent>> {
@@ -19,40 +21,42 @@ class RendererSystem : public ECSSystem<query::Get<TransformComponent, MeshRende
 
         auto& [transform, render] = item.components;
         Renderer* renderer = Engine.systems.getSystemChecked<Renderer>();
-        RenderEntity entity =
-            renderer->world().addRenderEntity(transform.transform, render.material, render.mesh);
-        render.renderEntity = entity;
 
+        // added under its parent right away, so the world can append it to the transform order
+        // instead of rebuilding it
+        RenderEntity parent(&renderer->world(), RenderItemHandle::invalidHandle());
         if (item.entity.getParent().isValid()) {
             auto parentRenderComponent =
                 item.entity.getParent().getComponent<MeshRendererComponent>();
             if (parentRenderComponent.isSome()) {
-                renderer->world().addChild(parentRenderComponent.value().renderEntity, entity);
+                parent = parentRenderComponent.value().renderEntity;
             }
         }
+
+        render.renderEntity = renderer->world().addRenderEntity(
+            transform.transform, render.material, render.mesh, parent);
     };
 
-    void onPreTick(QueryT::Item& item) override {
-        auto& [transform, render] = item.components;
-        Renderer* renderer = Engine.systems.getSystemChecked<Renderer>();
+    void preTick(ECS& ecs) override {
+        // gather every entity's state and submit it in one batch, the world only dirties what
+        // actually changed
+        _updates.clear();
+        for (auto item : ecs.query<query::Get<TransformComponent, MeshRendererComponent>>()) {
+            auto& [transform, render] = item.components;
+            if (!render.renderEntity.isValid())
+                continue;
 
-        if (!render.renderEntity.isValid()) {
-            // Engine.logger.error("RendererSystem: Entity {} has invalid render entity",
-            //                     item.entity.id());
-            // Engine.shutdown();
-            return;
+            _updates.push_back(RenderEntityUpdate{.entity = render.renderEntity,
+                .transform = transform.transform,
+                .material = render.material,
+                .mesh = render.mesh,
+                .renderLayer = render.renderLayer,
+                .tint = render.tint,
+                .isStatic = render.isStatic});
         }
 
-        // we do this to avoid temporaries from accessing
-        // the fields directly, and resubmission of the dirty entity
-        // in the destructor of the property proxy
-        RenderEntity::Properties props = render.renderEntity.prop();
-        props.transform = transform.transform;
-        props.mesh = render.mesh;
-        props.material = render.material;
-        props.renderLayer = render.renderLayer;
-
-        // Deconsturctor of props will resubmit the entity with the updated properties
+        Renderer* renderer = Engine.systems.getSystemChecked<Renderer>();
+        renderer->world().updateEntities(_updates);
     };
 
     void onEntityRemoved(QueryT::Item& item) override {
@@ -60,6 +64,9 @@ class RendererSystem : public ECSSystem<query::Get<TransformComponent, MeshRende
         Renderer* renderer = Engine.systems.getSystemChecked<Renderer>();
         renderer->world().removeRenderEntity(render.renderEntity);
     };
+
+   private:
+    std::vector<RenderEntityUpdate> _updates;
 };
 
 }  // namespace okay
@@ -28,7 +28,7 @@ class UISystem : public ECSSystem<query::Get<TransformComponent, UIComponent>> {
 
         Renderer* renderer = Engine.systems.getSystemChecked<Renderer>();
         UIElement root = ui::flexbox()(ui.uiBuilder());
-        ui.ui.update(root);
+        ui.ui.update(std::move(root));
         ui.ui.render(transform->position, ui.uiLayer, renderer);
     };
 
@@ -1,12 +1,21 @@
 #ifndef __ENGINE_H__
 #define __ENGINE_H__
 
+#include <okay/core/engine/job_system.hpp>
 #include <okay/core/engine/logger.hpp>
+#include <okay/core/engine/memory_tracker.hpp>
+#include <okay/core/engine/replay.hpp>
+#include <okay/core/engine/stats.hpp>
 #include <okay/core/engine/system.hpp>
 #include <okay/core/engine/time.hpp>
+#include <okay/core/util/frame_arena.hpp>
 
+#include <chrono>
 #include <functional>
 #include <source_location>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
 #include <utility>
 
 namespace okay {
@@ -16,6 +25,9 @@ class OkayEngine {
    public:
     SystemManager systems;
     Logger logger;
+    FrameStats stats;
+    Replay replay;
+    JobSystem jobs;
     std::unique_ptr<Time> time{std::make_unique<Time>()};
 
     OkayEngine() {}
@@ -131,53 +143,39 @@ class Game {
             system->postInitialize();
         }
 
-        Engine.time->reset();
-        while (Engine.shouldRun()) {
-            for (ISystem* system : enginePool) {
-                system->preTick();
-            }
-
-            for (ISystem* system : gamePool) {
-                system->preTick();
-            }
-
-            for (ISystem* system : levelPool) {
-                system->preTick();
+        if (Engine.replay.mode() == ReplayMode::OFF) {
+            if (Failable started = Engine.replay.startFromEnvironment(); !started) {
+                Engine.logger.error("{}", started.error());
             }
+        }
 
-            for (ISystem* system : enginePool) {
-                system->tick();
-                if (!Engine.shouldRun())
-                    break;
+        MemoryTracker::beginSteadyState();
+        Engine.time->reset();
+        while (Engine.shouldRun()) {
+            if (!Engine.replay.beginFrame(*Engine.time)) {
+                Engine.shutdown();
+                break;
             }
 
-            for (ISystem* system : gamePool) {
-                system->tick();
-                if (!Engine.shouldRun())
-                    break;
-            }
+            runPhase(enginePool, &ISystem::preTick);
+            runPhase(gamePool, &ISystem::preTick);
+            runPhase(levelPool, &ISystem::preTick);
 
-            for (ISystem* system : levelPool) {
-                system->tick();
-                if (!Engine.shouldRun())
-                    break;
-            }
+            runPhase(enginePool, &ISystem::tick, true);
+            runPhase(gamePool, &ISystem::tick, true);
+            runPhase(levelPool, &ISystem::tick, true);
 
             if (_onUpdate)
                 _onUpdate();
 
-            for (ISystem* system : enginePool) {
-                system->postTick();
-            }
-
-            for (ISystem* system : gamePool) {
-                system->postTick();
-            }
-
-            for (ISystem* system : levelPool) {
-                system->postTick();
-            }
+            runPhase(enginePool, &ISystem::postTick);
+            runPhase(gamePool, &ISystem::postTick);
+            runPhase(levelPool, &ISystem::postTick);
 
+            Engine.replay.endFrame();
+            MemoryTracker::endFrame();
+            Engine.stats.endFrame();
+            FrameArena::endFrame();
             Engine.time->updateDeltaTime();
 
             Engine._frameCount++;
@@ -196,6 +194,13 @@ class Game {
             system->shutdown();
         }
 
+        Engine.replay.stop();
+        Engine.logger.flushSuppressed();
+
+        if constexpr (MemoryTracker::enabled()) {
+            Engine.logger.info("Memory report:\n{}", MemoryTracker::report().toString());
+        }
+
         std::cout << "Shutdown location: " << Engine.shutdownLoc().file_name() << ":"
                   << Engine.shutdownLoc().line() << std::endl;
 
@@ -208,6 +213,34 @@ class Game {
     std::function<void()> _onUpdate;
     std::function<void()> _onShutdown;
 
+    // "system.<type name>" stat per system, holds microseconds spent in its ticks each frame
+    std::unordered_map<ISystem*, FrameStats::StatId> _systemStats;
+
+    FrameStats::StatId systemStat(ISystem* system) {
+        auto it = _systemStats.find(system);
+        if (it != _systemStats.end())
+            return it->second;
+
+        std::string name = std::string("system.") + typeid(*system).name();
+        FrameStats::StatId id = Engine.stats.registerStat(name, StatKind::COUNTER);
+        _systemStats.emplace(system, id);
+        return id;
+    }
+
+    void runPhase(SystemPool& pool, void (ISystem::*phase)(), bool stopOnShutdown = false) {
+        for (ISystem* system : pool) {
+            auto start = std::chrono::steady_clock::now();
+            (system->*phase)();
+            auto elapsed = std::chrono::steady_clock::now() - start;
+
+            Engine.stats.add(systemStat(system),
+                std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+
+            if (stopOnShutdown && !Engine.shouldRun())
+                break;
+        }
+    }
+
     static const std::vector<OkaySystemDescriptor> REQUIRED_SYSTEMS;
 };
 
@@ -0,0 +1,99 @@
+#include "job_system.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+
+using namespace okay;
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _wake.notify_all();
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::size_t JobSystem::threadCount() {
+    if (!_started)
+        start();
+    return _workers.size() + 1;
+}
+
+void JobSystem::start() {
+    _started = true;
+
+    std::size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    if (const char* env = std::getenv("OKAY_JOB_THREADS")) {
+        threads = static_cast<std::size_t>(std::max(1, std::atoi(env)));
+    }
+
+    for (std::size_t i = 1; i < threads; ++i) {
+        _workers.emplace_back([this]() { workerLoop(); });
+    }
+}
+
+void JobSystem::run(std::size_t count, std::size_t chunkSize, ChunkFn fn, void* context) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _fn = fn;
+        _context = context;
+        _count = count;
+        _chunkSize = chunkSize;
+        _chunkCount = (count + chunkSize - 1) / chunkSize;
+        _nextChunk.store(0, std::memory_order_relaxed);
+        _remainingChunks.store(_chunkCount, std::memory_order_relaxed);
+        ++_generation;
+    }
+    _wake.notify_all();
+
+    runChunks();
+
+    // workers that joined still read the job, so it stays put until they have left
+    std::unique_lock<std::mutex> lock(_mutex);
+    _done.wait(lock, [this]() {
+        return _remainingChunks.load(std::memory_order_acquire) == 0 && _activeWorkers == 0;
+    });
+}
+
+void JobSystem::runChunks() {
+    while (true) {
+        std::size_t chunk = _nextChunk.fetch_add(1, std::memory_order_relaxed);
+        if (chunk >= _chunkCount)
+            return;
+
+        std::size_t begin = chunk * _chunkSize;
+        _fn(_context, begin, std::min(_count, begin + _chunkSize));
+
+        if (_remainingChunks.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _done.notify_all();
+        }
+    }
+}
+
+void JobSystem::workerLoop() {
+    std::uint64_t seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _wake.wait(lock, [&]() { return _stopping || _generation != seen; });
+            if (_stopping)
+                return;
+            seen = _generation;
+
+            // a job that already finished may be replaced as soon as the lock is released
+            if (_remainingChunks.load(std::memory_order_acquire) == 0)
+                continue;
+            ++_activeWorkers;
+        }
+
+        runChunks();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (--_activeWorkers == 0)
+            _done.notify_all();
+    }
+}
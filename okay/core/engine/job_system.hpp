@@ -0,0 +1,83 @@
+#ifndef __JOB_SYSTEM_H__
+#define __JOB_SYSTEM_H__
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace okay {
+
+// A fixed set of worker threads for splitting frame work over the other cores. There is one
+// job at a time: parallelFor blocks until every chunk is done and the calling thread works on
+// chunks too. Workers start on first use, OKAY_JOB_THREADS overrides the thread count (the
+// caller included, 1 runs everything inline).
+class JobSystem {
+   public:
+    JobSystem() = default;
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    // threads that run chunks, the caller included
+    std::size_t threadCount();
+
+    // Runs fn(begin, end) over [0, count) split into chunks of chunkSize. Chunks may run in
+    // any order and on any thread, so fn must only write state owned by its chunk. Not
+    // reentrant, fn must not call parallelFor.
+    template <typename Fn>
+    void parallelFor(std::size_t count, std::size_t chunkSize, Fn&& fn) {
+        if (count == 0)
+            return;
+        if (count <= chunkSize || threadCount() == 1) {
+            for (std::size_t begin = 0; begin < count; begin += chunkSize) {
+                fn(begin, std::min(count, begin + chunkSize));
+            }
+            return;
+        }
+
+        run(count,
+            chunkSize,
+            [](void* context, std::size_t begin, std::size_t end) {
+                (*static_cast<std::remove_reference_t<Fn>*>(context))(begin, end);
+            },
+            &fn);
+    }
+
+   private:
+    using ChunkFn = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    std::vector<std::thread> _workers;
+    bool _started{false};
+    bool _stopping{false};
+
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::condition_variable _done;
+    std::uint64_t _generation{0};
+    std::size_t _activeWorkers{0};
+
+    // the current job, only written while no worker is inside it
+    ChunkFn _fn{nullptr};
+    void* _context{nullptr};
+    std::size_t _count{0};
+    std::size_t _chunkSize{0};
+    std::size_t _chunkCount{0};
+    std::atomic<std::size_t> _nextChunk{0};
+    std::atomic<std::size_t> _remainingChunks{0};
+
+    void start();
+    void run(std::size_t count, std::size_t chunkSize, ChunkFn fn, void* context);
+    void runChunks();
+    void workerLoop();
+};
+
+}  // namespace okay
+
+#endif  // __JOB_SYSTEM_H__
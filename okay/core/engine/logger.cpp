@@ -44,6 +44,21 @@ void Logger::setOptions(const OkayLoggerOptions& options) {
     openFileIfNeeded();
 }
 
+void Logger::flushSuppressed() {
+    LogRateLimiter::drainSuppressed([this](const char* file,
+                                        std::uint32_t line,
+                                        std::uint32_t count) {
+        const char* p = file ? strrchr(file, '/') : nullptr;
+        const char* shortName = p ? p + 1 : (file ? file : "?");
+        writeRepeated<Severity::INFO>(std::cout, true, shortName, line, count);
+        if (_file.is_open()) {
+            std::lock_guard g(_fileMtx);
+            writeRepeated<Severity::INFO>(_file, false, shortName, line, count);
+            _file.flush();
+        }
+    });
+}
+
 Logger::Logger(const OkayLoggerOptions& options) : _options(options) {
     openFileIfNeeded();
 }
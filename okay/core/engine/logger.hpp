@@ -1,6 +1,11 @@
 #ifndef OKAY_LOGGER_HPP
 #define OKAY_LOGGER_HPP
 
+#include <okay/core/engine/memory_tracker.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <ctime>
@@ -39,6 +44,10 @@ enum class Verbosity : std::uint8_t {
 struct OkayLoggerOptions {
     bool ToFile{true};
     std::string filePrefix{"log_"};
+    // per call site: at most rateLimitBurst messages every rateLimitWindowMs, the rest are
+    // counted and reported as "repeated N times". a burst of 0 disables rate limiting
+    std::uint32_t rateLimitBurst{5};
+    std::uint32_t rateLimitWindowMs{1000};
 };
 
 struct LogPhrases {
@@ -67,10 +76,22 @@ struct LogPhrases {
 struct OkayLog final {
     std::string_view fmt;
     std::source_location loc;
+    std::uint64_t siteKey;
 
     template <typename T>
     consteval OkayLog(T&& fmt, std::source_location loc = std::source_location::current())
-        : fmt(std::forward<T>(fmt)), loc(loc) {}
+        : fmt(std::forward<T>(fmt)), loc(loc), siteKey(hashSite(loc)) {}
+
+    // FNV-1a over file name and line, evaluated at compile time so the per-site
+    // rate limiter can index its table without hashing at runtime
+    static consteval std::uint64_t hashSite(const std::source_location& loc) {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (const char* c = loc.file_name(); *c != '\0'; ++c) {
+            hash = (hash ^ static_cast<unsigned char>(*c)) * 1099511628211ull;
+        }
+        hash = (hash ^ loc.line()) * 1099511628211ull;
+        return hash == 0 ? 1 : hash;
+    }
 
     template <Severity S, Verbosity V>
     static consteval bool logEnabled() {
@@ -95,6 +116,101 @@ struct OkayLog final {
     }
 };
 
+// rate limiting state for a single call site. slots live in a fixed open addressed table
+// indexed by OkayLog::siteKey, a site keeps its slot for the lifetime of the program
+struct LogSiteState {
+    std::atomic<std::uint64_t> key{0};
+    std::atomic<const char*> file{nullptr};
+    std::atomic<std::uint32_t> line{0};
+    std::atomic<std::int64_t> windowStartMs{0};
+    std::atomic<std::uint32_t> emitted{0};
+    std::atomic<std::uint32_t> suppressed{0};
+};
+
+class LogRateLimiter {
+   public:
+    static constexpr std::size_t TABLE_SIZE = 1024;
+
+    // returns true if the message should be emitted. repeated is set to the number of
+    // messages that were suppressed at this site since the last emitted one
+    static bool admit(const OkayLog& log,
+        std::uint32_t burst,
+        std::uint32_t windowMs,
+        std::uint32_t& repeated) {
+        repeated = 0;
+        if (burst == 0)
+            return true;
+
+        std::int64_t now = nowMs();
+        bool claimed = false;
+        LogSiteState* found = findSite(log, now, claimed);
+        // a site's first message always goes out, a site whose probed slots all belong to other
+        // sites isn't rate limited
+        if (found == nullptr || claimed)
+            return true;
+        LogSiteState& site = *found;
+
+        if (now - site.windowStartMs.load(std::memory_order_relaxed) >= windowMs) {
+            repeated = site.suppressed.exchange(0, std::memory_order_relaxed);
+            site.windowStartMs.store(now, std::memory_order_relaxed);
+            site.emitted.store(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        if (site.emitted.fetch_add(1, std::memory_order_relaxed) < burst)
+            return true;
+
+        site.suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // calls fn(file, line, count) for every site with suppressed messages and resets them
+    template <typename Fn>
+    static void drainSuppressed(Fn&& fn) {
+        for (LogSiteState& site : _sites) {
+            std::uint32_t count = site.suppressed.exchange(0, std::memory_order_relaxed);
+            if (count > 0)
+                fn(site.file.load(std::memory_order_relaxed),
+                    site.line.load(std::memory_order_relaxed),
+                    count);
+        }
+    }
+
+   private:
+    static constexpr std::size_t MAX_PROBES = 16;
+
+    static inline std::array<LogSiteState, TABLE_SIZE> _sites{};
+
+    // the slot of the site, claiming a free one the first time the site logs. Sites never evict
+    // each other, so none of them loses its window or its suppressed count
+    static LogSiteState* findSite(const OkayLog& log, std::int64_t now, bool& claimed) {
+        for (std::size_t probe = 0; probe < MAX_PROBES; ++probe) {
+            LogSiteState& site = _sites[(log.siteKey + probe) & (TABLE_SIZE - 1)];
+            std::uint64_t key = site.key.load(std::memory_order_acquire);
+            if (key == 0) {
+                if (site.key.compare_exchange_strong(key, log.siteKey, std::memory_order_acq_rel)) {
+                    site.file.store(log.loc.file_name(), std::memory_order_relaxed);
+                    site.line.store(log.loc.line(), std::memory_order_relaxed);
+                    site.windowStartMs.store(now, std::memory_order_relaxed);
+                    site.emitted.store(1, std::memory_order_relaxed);
+                    claimed = true;
+                    return &site;
+                }
+                // another thread claimed it first, key now holds its site
+            }
+            if (key == log.siteKey)
+                return &site;
+        }
+        return nullptr;
+    }
+
+    static std::int64_t nowMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+};
+
 class Logger {
    public:
     Logger() = default;
@@ -123,6 +239,9 @@ class Logger {
         emit<Severity::ERROR, V, Ts...>(std::cerr, log, std::forward<Ts>(ts)...);
     }
 
+    // reports every call site that still has rate limited messages pending
+    void flushSuppressed();
+
    private:
     OkayLoggerOptions _options{};
     std::ofstream _file{};
@@ -136,6 +255,15 @@ class Logger {
         if constexpr (!OkayLog::logEnabled<S, V>())
             return;
 
+        std::uint32_t repeated = 0;
+        if (!LogRateLimiter::admit(
+                log, _options.rateLimitBurst, _options.rateLimitWindowMs, repeated))
+            return;
+
+        AllocationScope allocations(MemoryTag::LOGGER);
+
+        if (repeated > 0)
+            writeRepeated<S>(os, true, log.shortFileName(), log.loc.line(), repeated);
         log.invoke<S, V, Ts...>(os, true, std::forward<Ts>(ts)...);
 
         if (_options.ToFile && !_triedToOpenFile) {
@@ -146,11 +274,27 @@ class Logger {
 
         if (_file.is_open()) {
             std::lock_guard g(_fileMtx);
+            if (repeated > 0)
+                writeRepeated<S>(_file, false, log.shortFileName(), log.loc.line(), repeated);
             log.invoke<S, V, Ts...>(_file, false, std::forward<Ts>(ts)...);
             _file.flush();
         }
     }
 
+    template <Severity S>
+    static void writeRepeated(std::ostream& os,
+        bool enableColor,
+        const char* file,
+        std::uint32_t line,
+        std::uint32_t count) {
+        os << LogPhrases::severityColor<S>(enableColor);
+        os << LogPhrases::severityTag<S>() << '[' << file << ':' << line << "] ";
+        os << "previous message repeated " << count << " times";
+        if (enableColor)
+            os << LogPhrases::COLOR_RESET;
+        os << '\n';
+    }
+
     static std::string makeStartFilename(const std::string& prefix);
 
     void openFileIfNeeded();
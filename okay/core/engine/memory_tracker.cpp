@@ -0,0 +1,295 @@
+#include "memory_tracker.hpp"
+
+#include <okay/core/engine/engine.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <format>
+#include <new>
+
+using namespace okay;
+
+namespace {
+
+constexpr std::size_t TAG_COUNT = static_cast<std::size_t>(MemoryTag::COUNT);
+
+constexpr std::string_view TAG_NAMES[TAG_COUNT] = {
+    "untagged",
+    "ecs",
+    "render_world",
+    "mesh_buffer",
+    "textures",
+    "fonts",
+    "assets",
+    "ui",
+    "logger",
+};
+
+struct TagCounters {
+    std::atomic<std::int64_t> liveBytes{0};
+    std::atomic<std::int64_t> peakBytes{0};
+    std::atomic<std::uint64_t> allocations{0};
+};
+
+// all constant-initialized, so they're usable by operator new before main runs
+std::array<TagCounters, TAG_COUNT> s_tags{};
+std::atomic<std::uint64_t> s_frameAllocations{0};
+std::atomic<std::uint64_t> s_frameBytes{0};
+
+thread_local MemoryTag t_currentTag = MemoryTag::UNTAGGED;
+
+// main thread only, updated in endFrame
+std::uint64_t s_lastFrameAllocations = 0;
+std::uint64_t s_lastFrameBytes = 0;
+std::uint64_t s_framesTracked = 0;
+std::uint64_t s_framesSinceSteadyState = 0;
+std::uint64_t s_warmupFrames = 120;
+std::uint64_t s_steadyStateAllocatingFrames = 0;
+bool s_inAllocatingStreak = false;
+
+#if OKAY_TRACK_ALLOCATIONS
+
+// stored right in front of every tracked allocation so frees can be attributed
+struct alignas(16) AllocationHeader {
+    std::uint64_t size;
+    std::uint32_t offset;  // from the start of the malloc'd block to the user pointer
+    MemoryTag tag;
+};
+
+static_assert(sizeof(AllocationHeader) == 16);
+
+void recordAllocation(MemoryTag tag, std::size_t size) {
+    TagCounters& counters = s_tags[static_cast<std::size_t>(tag)];
+    std::int64_t live =
+        counters.liveBytes.fetch_add(static_cast<std::int64_t>(size), std::memory_order_relaxed) +
+        static_cast<std::int64_t>(size);
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+
+    std::int64_t peak = counters.peakBytes.load(std::memory_order_relaxed);
+    while (live > peak &&
+           !counters.peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+    }
+
+    s_frameAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_frameBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void* trackedAllocate(std::size_t size, std::size_t alignment) {
+    alignment = std::max(alignment, alignof(AllocationHeader));
+
+    std::byte* raw = static_cast<std::byte*>(
+        std::malloc(size + sizeof(AllocationHeader) + alignment));
+    if (raw == nullptr)
+        return nullptr;
+
+    std::uintptr_t rawAddress = reinterpret_cast<std::uintptr_t>(raw);
+    std::uintptr_t user =
+        (rawAddress + sizeof(AllocationHeader) + alignment - 1) & ~(alignment - 1);
+
+    AllocationHeader* header = reinterpret_cast<AllocationHeader*>(user) - 1;
+    header->size = size;
+    header->offset = static_cast<std::uint32_t>(user - rawAddress);
+    header->tag = t_currentTag;
+
+    recordAllocation(header->tag, size);
+    return reinterpret_cast<void*>(user);
+}
+
+void trackedFree(void* ptr) {
+    if (ptr == nullptr)
+        return;
+
+    AllocationHeader* header = static_cast<AllocationHeader*>(ptr) - 1;
+    s_tags[static_cast<std::size_t>(header->tag)].liveBytes.fetch_sub(
+        static_cast<std::int64_t>(header->size), std::memory_order_relaxed);
+
+    std::free(static_cast<std::byte*>(ptr) - header->offset);
+}
+
+void* trackedAllocateOrThrow(std::size_t size, std::size_t alignment) {
+    if (void* p = trackedAllocate(size, alignment))
+        return p;
+    throw std::bad_alloc();
+}
+
+#endif
+
+}  // namespace
+
+#if OKAY_TRACK_ALLOCATIONS
+
+void* operator new(std::size_t size) {
+    return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size) {
+    return trackedAllocateOrThrow(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return trackedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return trackedAllocateOrThrow(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, __STDCPP_DEFAULT_NEW_ALIGNMENT__);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](
+    std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return trackedAllocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree(ptr);
+}
+
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    trackedFree(ptr);
+}
+
+#endif
+
+MemoryTag MemoryTracker::currentTag() {
+    return t_currentTag;
+}
+
+void MemoryTracker::setCurrentTag(MemoryTag tag) {
+    t_currentTag = tag;
+}
+
+void MemoryTracker::setWarmupFrames(std::uint64_t frames) {
+    s_warmupFrames = frames;
+}
+
+void MemoryTracker::beginSteadyState() {
+    s_framesSinceSteadyState = 0;
+    s_inAllocatingStreak = false;
+    s_frameAllocations.store(0, std::memory_order_relaxed);
+    s_frameBytes.store(0, std::memory_order_relaxed);
+}
+
+void MemoryTracker::endFrame() {
+    if constexpr (!enabled())
+        return;
+
+    s_lastFrameAllocations = s_frameAllocations.exchange(0, std::memory_order_relaxed);
+    s_lastFrameBytes = s_frameBytes.exchange(0, std::memory_order_relaxed);
+    s_framesTracked++;
+
+    if (++s_framesSinceSteadyState <= s_warmupFrames)
+        return;
+
+    if (s_lastFrameAllocations == 0) {
+        s_inAllocatingStreak = false;
+        return;
+    }
+
+    s_steadyStateAllocatingFrames++;
+
+    // only report the first frame of a streak. logging allocates itself, so reporting every
+    // frame would keep the streak alive forever
+    if (!s_inAllocatingStreak) {
+        Engine.logger.warn("Frame {} allocated {} times ({} bytes) in steady state",
+            Engine.frameCount(),
+            s_lastFrameAllocations,
+            s_lastFrameBytes);
+        s_inAllocatingStreak = true;
+    }
+}
+
+MemoryReport MemoryTracker::report() {
+    MemoryReport report;
+    report.enabled = enabled();
+
+    for (std::size_t i = 0; i < TAG_COUNT; ++i) {
+        MemoryTagReport& tag = report.tags[i];
+        tag.name = TAG_NAMES[i];
+        tag.liveBytes = s_tags[i].liveBytes.load(std::memory_order_relaxed);
+        tag.peakBytes = s_tags[i].peakBytes.load(std::memory_order_relaxed);
+        tag.allocations = s_tags[i].allocations.load(std::memory_order_relaxed);
+        report.liveBytes += tag.liveBytes;
+    }
+
+    report.lastFrameAllocations = s_lastFrameAllocations;
+    report.lastFrameBytes = s_lastFrameBytes;
+    report.framesTracked = s_framesTracked;
+    report.steadyStateAllocatingFrames = s_steadyStateAllocatingFrames;
+    return report;
+}
+
+std::string_view MemoryTracker::tagName(MemoryTag tag) {
+    return TAG_NAMES[static_cast<std::size_t>(tag)];
+}
+
+std::string MemoryReport::toString() const {
+    if (!enabled)
+        return "allocation tracking disabled (build with OKAY_TRACK_ALLOCATIONS=ON)";
+
+    std::string out = std::format("{:<14} {:>14} {:>14} {:>12}\n", "tag", "live", "peak", "allocs");
+    for (const MemoryTagReport& tag : tags) {
+        out += std::format("{:<14} {:>14} {:>14} {:>12}\n",
+            tag.name,
+            tag.liveBytes,
+            tag.peakBytes,
+            tag.allocations);
+    }
+
+    out += std::format("live bytes: {}, frames: {}, allocating steady state frames: {}",
+        liveBytes,
+        framesTracked,
+        steadyStateAllocatingFrames);
+    return out;
+}
@@ -0,0 +1,104 @@
+#ifndef __MEMORY_TRACKER_H__
+#define __MEMORY_TRACKER_H__
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// heap tracking replaces the global operator new/delete, so it's opt-in.
+// configure with -DOKAY_TRACK_ALLOCATIONS=ON to enable it
+#ifndef OKAY_TRACK_ALLOCATIONS
+#define OKAY_TRACK_ALLOCATIONS 0
+#endif
+
+namespace okay {
+
+// subsystem that heap allocations are attributed to, see AllocationScope
+enum class MemoryTag : std::uint8_t {
+    UNTAGGED = 0,
+    ECS,
+    RENDER_WORLD,
+    MESH_BUFFER,
+    TEXTURES,
+    FONTS,
+    ASSETS,
+    UI,
+    LOGGER,
+    COUNT
+};
+
+struct MemoryTagReport {
+    std::string_view name;
+    std::int64_t liveBytes{0};
+    std::int64_t peakBytes{0};
+    std::uint64_t allocations{0};
+};
+
+struct MemoryReport {
+    bool enabled{false};
+    std::array<MemoryTagReport, static_cast<std::size_t>(MemoryTag::COUNT)> tags{};
+    std::int64_t liveBytes{0};
+
+    // totals for the last completed frame
+    std::uint64_t lastFrameAllocations{0};
+    std::uint64_t lastFrameBytes{0};
+
+    std::uint64_t framesTracked{0};
+    // frames past the warmup that still allocated
+    std::uint64_t steadyStateAllocatingFrames{0};
+
+    std::string toString() const;
+};
+
+class MemoryTracker {
+   public:
+    static constexpr bool enabled() {
+        return OKAY_TRACK_ALLOCATIONS != 0;
+    }
+
+    static MemoryTag currentTag();
+    static void setCurrentTag(MemoryTag tag);
+
+    // frames after initialization that may allocate before a frame is flagged
+    static void setWarmupFrames(std::uint64_t frames);
+
+    // restarts the warmup, called by the engine once initialization is done
+    static void beginSteadyState();
+
+    // closes the frame's counters and flags steady state allocation, called by the engine
+    static void endFrame();
+
+    static MemoryReport report();
+
+    static std::string_view tagName(MemoryTag tag);
+};
+
+// attributes every allocation made on this thread while it's alive to tag
+class AllocationScope {
+   public:
+#if OKAY_TRACK_ALLOCATIONS
+    explicit AllocationScope(MemoryTag tag) : _previous(MemoryTracker::currentTag()) {
+        MemoryTracker::setCurrentTag(tag);
+    }
+
+    ~AllocationScope() {
+        MemoryTracker::setCurrentTag(_previous);
+    }
+#else
+    explicit AllocationScope(MemoryTag) {}
+#endif
+
+    AllocationScope(const AllocationScope&) = delete;
+    AllocationScope& operator=(const AllocationScope&) = delete;
+
+#if OKAY_TRACK_ALLOCATIONS
+   private:
+    MemoryTag _previous;
+#endif
+};
+
+}  // namespace okay
+
+#endif  // __MEMORY_TRACKER_H__
@@ -0,0 +1,231 @@
+#include "replay.hpp"
+
+#include <okay/core/engine/engine.hpp>
+
+#include <cstdlib>
+
+using namespace okay;
+
+namespace {
+
+constexpr std::size_t FRAME_HEADER_SIZE = 3 * sizeof(std::uint32_t);
+constexpr std::size_t CHUNK_HEADER_SIZE = 2 * sizeof(std::uint32_t);
+
+void appendU32(std::vector<std::byte>& out, std::uint32_t value) {
+    const std::byte* bytes = reinterpret_cast<const std::byte*>(&value);
+    out.insert(out.end(), bytes, bytes + sizeof(value));
+}
+
+std::uint32_t readU32(const std::byte* at) {
+    std::uint32_t value;
+    std::memcpy(&value, at, sizeof(value));
+    return value;
+}
+
+}  // namespace
+
+Replay::~Replay() {
+    stop();
+}
+
+Failable Replay::startRecording(const std::filesystem::path& path) {
+    stop();
+
+    _out.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!_out.is_open()) {
+        return Failable::errorResult("Failed to open replay file for writing: " + path.string());
+    }
+
+    std::vector<std::byte> header;
+    appendU32(header, MAGIC);
+    appendU32(header, VERSION);
+    _out.write(reinterpret_cast<const char*>(header.data()), header.size());
+
+    _frame.clear();
+    _frameOffsets.clear();
+    _frameIndex = 0;
+    _mode = ReplayMode::RECORD;
+    return Failable::ok({});
+}
+
+Failable Replay::startReplay(const std::filesystem::path& path) {
+    stop();
+
+    std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open()) {
+        return Failable::errorResult("Failed to open replay file: " + path.string());
+    }
+
+    std::size_t fileSize = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+    _data.resize(fileSize);
+    in.read(reinterpret_cast<char*>(_data.data()), fileSize);
+
+    if (fileSize < 2 * sizeof(std::uint32_t) || readU32(_data.data()) != MAGIC) {
+        return Failable::errorResult("Not a replay file: " + path.string());
+    }
+
+    if (std::uint32_t version = readU32(_data.data() + sizeof(std::uint32_t));
+        version != VERSION) {
+        return Failable::errorResult("Unsupported replay version " + std::to_string(version) +
+                                     " in " + path.string());
+    }
+
+    // index the frames up front so a truncated file fails here instead of mid-run
+    _frameOffsets.clear();
+    std::size_t offset = 2 * sizeof(std::uint32_t);
+    while (offset + FRAME_HEADER_SIZE <= fileSize) {
+        std::size_t frameStart = offset;
+        std::uint32_t chunkCount = readU32(_data.data() + offset + 2 * sizeof(std::uint32_t));
+        offset += FRAME_HEADER_SIZE;
+
+        for (std::uint32_t i = 0; i < chunkCount; ++i) {
+            if (offset + CHUNK_HEADER_SIZE > fileSize) {
+                return Failable::errorResult("Truncated replay file: " + path.string());
+            }
+            offset += CHUNK_HEADER_SIZE + readU32(_data.data() + offset + sizeof(std::uint32_t));
+        }
+
+        if (offset > fileSize) {
+            return Failable::errorResult("Truncated replay file: " + path.string());
+        }
+
+        _frameOffsets.push_back(frameStart);
+    }
+
+    _frameIndex = 0;
+    _mode = ReplayMode::REPLAY;
+    return Failable::ok({});
+}
+
+Failable Replay::startFromEnvironment() {
+    if (const char* path = std::getenv("OKAY_REPLAY")) {
+        return startReplay(path);
+    }
+
+    if (const char* path = std::getenv("OKAY_RECORD")) {
+        return startRecording(path);
+    }
+
+    return Failable::ok({});
+}
+
+void Replay::stop() {
+    if (_out.is_open()) {
+        _out.close();
+    }
+
+    _data.clear();
+    _chunks.clear();
+    _mode = ReplayMode::OFF;
+}
+
+bool Replay::beginFrame(Time& time) {
+    if (_mode == ReplayMode::RECORD) {
+        // drive time with the values we record, so the recorded run sees exactly what the
+        // replay will
+        std::uint32_t deltaMs = time.deltaTimeMs();
+        std::uint32_t sinceStartMs = time.wallTimeSinceStartMs();
+        time.drive(deltaMs, sinceStartMs);
+
+        _frame.clear();
+        _frameChunkCount = 0;
+        appendU32(_frame, deltaMs);
+        appendU32(_frame, sinceStartMs);
+        appendU32(_frame, 0);  // chunk count, patched in endFrame
+        return true;
+    }
+
+    if (_mode == ReplayMode::REPLAY) {
+        if (_frameIndex >= _frameOffsets.size())
+            return false;
+
+        const std::byte* frame = _data.data() + _frameOffsets[_frameIndex];
+        time.drive(readU32(frame), readU32(frame + sizeof(std::uint32_t)));
+
+        std::uint32_t chunkCount = readU32(frame + 2 * sizeof(std::uint32_t));
+        std::size_t offset = _frameOffsets[_frameIndex] + FRAME_HEADER_SIZE;
+
+        _chunks.clear();
+        for (std::uint32_t i = 0; i < chunkCount; ++i) {
+            Chunk chunk;
+            chunk.channel = readU32(_data.data() + offset);
+            chunk.size = readU32(_data.data() + offset + sizeof(std::uint32_t));
+            chunk.offset = offset + CHUNK_HEADER_SIZE;
+            chunk.consumed = false;
+            _chunks.push_back(chunk);
+            offset = chunk.offset + chunk.size;
+        }
+    }
+
+    return true;
+}
+
+void Replay::endFrame() {
+    if (_mode == ReplayMode::RECORD) {
+        std::memcpy(_frame.data() + 2 * sizeof(std::uint32_t),
+            &_frameChunkCount,
+            sizeof(_frameChunkCount));
+        _out.write(reinterpret_cast<const char*>(_frame.data()), _frame.size());
+    } else if (_mode == ReplayMode::REPLAY) {
+        for (const Chunk& chunk : _chunks) {
+            if (!chunk.consumed) {
+                Engine.logger.warn("Replay desync: frame {} left channel {} unread",
+                    _frameIndex,
+                    chunk.channel);
+            }
+        }
+    }
+
+    if (_mode != ReplayMode::OFF)
+        _frameIndex++;
+}
+
+void Replay::streamBytes(std::uint32_t channel, void* value, std::size_t size) {
+    if (_mode == ReplayMode::RECORD) {
+        writeChunk(channel, value, size);
+        return;
+    }
+
+    const std::byte* data = nullptr;
+    std::size_t recordedSize = 0;
+    if (!readChunk(channel, data, recordedSize))
+        return;
+
+    if (recordedSize != size) {
+        Engine.logger.warn("Replay desync: frame {} channel {} recorded {} bytes, expected {}",
+            _frameIndex,
+            channel,
+            recordedSize,
+            size);
+        return;
+    }
+
+    std::memcpy(value, data, size);
+}
+
+void Replay::writeChunk(std::uint32_t channel, const void* data, std::size_t size) {
+    appendU32(_frame, channel);
+    appendU32(_frame, static_cast<std::uint32_t>(size));
+
+    const std::byte* bytes = static_cast<const std::byte*>(data);
+    _frame.insert(_frame.end(), bytes, bytes + size);
+    _frameChunkCount++;
+}
+
+bool Replay::readChunk(std::uint32_t channel, const std::byte*& data, std::size_t& size) {
+    for (Chunk& chunk : _chunks) {
+        if (chunk.consumed || chunk.channel != channel)
+            continue;
+
+        chunk.consumed = true;
+        data = _data.data() + chunk.offset;
+        size = chunk.size;
+        return true;
+    }
+
+    Engine.logger.warn("Replay desync: frame {} has nothing recorded on channel {}",
+        _frameIndex,
+        channel);
+    return false;
+}
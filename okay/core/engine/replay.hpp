@@ -0,0 +1,125 @@
+#ifndef __REPLAY_H__
+#define __REPLAY_H__
+
+#include <okay/core/engine/time.hpp>
+#include <okay/core/util/result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <type_traits>
+#include <vector>
+
+namespace okay {
+
+enum class ReplayMode : std::uint8_t { OFF, RECORD, REPLAY };
+
+// Records the frame timing and any data the game streams through it to a binary file, and
+// plays it back so two runs see exactly the same workload.
+//
+// File layout (host byte order):
+//   header: magic "OKRP", u32 version
+//   frame:  u32 deltaMs, u32 sinceStartMs, u32 chunkCount, chunkCount * chunk
+//   chunk:  u32 channel, u32 size, size bytes
+//
+// The recording ends with the frame the engine shut down on, replaying past it shuts the
+// engine down on the same frame.
+class Replay {
+   public:
+    static constexpr std::uint32_t MAGIC = 0x50524B4F;  // "OKRP"
+    static constexpr std::uint32_t VERSION = 1;
+
+    ~Replay();
+
+    Failable startRecording(const std::filesystem::path& path);
+    Failable startReplay(const std::filesystem::path& path);
+
+    // OKAY_RECORD=<file> or OKAY_REPLAY=<file>, lets CI pick a mode without rebuilding
+    Failable startFromEnvironment();
+
+    void stop();
+
+    ReplayMode mode() const {
+        return _mode;
+    }
+
+    bool recording() const {
+        return _mode == ReplayMode::RECORD;
+    }
+
+    bool replaying() const {
+        return _mode == ReplayMode::REPLAY;
+    }
+
+    std::size_t frameIndex() const {
+        return _frameIndex;
+    }
+
+    std::size_t frameCount() const {
+        return _frameOffsets.size();
+    }
+
+    // When recording, writes value to the current frame. When replaying, overwrites value
+    // with what was recorded on this frame for the channel. Does nothing otherwise.
+    // Chunks are matched per channel in the order they were streamed.
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void stream(std::uint32_t channel, T& value) {
+        if (_mode == ReplayMode::OFF)
+            return;
+        streamBytes(channel, &value, sizeof(T));
+    }
+
+    template <typename T>
+        requires std::is_trivially_copyable_v<T>
+    void stream(std::uint32_t channel, std::vector<T>& values) {
+        if (_mode == ReplayMode::RECORD) {
+            writeChunk(channel, values.data(), values.size() * sizeof(T));
+        } else if (_mode == ReplayMode::REPLAY) {
+            const std::byte* data = nullptr;
+            std::size_t size = 0;
+            if (readChunk(channel, data, size)) {
+                values.resize(size / sizeof(T));
+                std::memcpy(values.data(), data, values.size() * sizeof(T));
+            }
+        }
+    }
+
+    // called by the engine at the start of a frame, drives time when replaying.
+    // returns false once a replay has run out of frames
+    bool beginFrame(Time& time);
+
+    // called by the engine once a frame is done, writes it out when recording
+    void endFrame();
+
+   private:
+    struct Chunk {
+        std::uint32_t channel;
+        std::uint32_t size;
+        std::size_t offset;
+        bool consumed;
+    };
+
+    ReplayMode _mode{ReplayMode::OFF};
+    std::size_t _frameIndex{0};
+
+    // recording
+    std::ofstream _out;
+    std::vector<std::byte> _frame;
+    std::uint32_t _frameChunkCount{0};
+
+    // replaying, the whole file is kept in memory so frames never touch the disk
+    std::vector<std::byte> _data;
+    std::vector<std::size_t> _frameOffsets;
+    std::vector<Chunk> _chunks;
+
+    void streamBytes(std::uint32_t channel, void* value, std::size_t size);
+    void writeChunk(std::uint32_t channel, const void* data, std::size_t size);
+    bool readChunk(std::uint32_t channel, const std::byte*& data, std::size_t& size);
+};
+
+}  // namespace okay
+
+#endif  // __REPLAY_H__
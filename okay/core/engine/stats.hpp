@@ -0,0 +1,183 @@
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace okay {
+
+enum class StatKind : std::uint8_t {
+    COUNTER,  // accumulated over a frame, reset to 0 when the frame ends
+    GAUGE     // holds the last value set, sampled when the frame ends
+};
+
+// stats the engine populates itself. custom stats are registered after these
+enum class Stat : std::uint32_t {
+    DRAW_CALLS = 0,
+    SHADER_SWITCHES,
+    MATERIAL_SWITCHES,
+    GL_STATE_CHANGES,
+    BYTES_UPLOADED,
+    VISIBLE_ITEMS,
+    CULLED_ITEMS,
+    ENTITY_COUNT,
+    QUERY_ITERATIONS,
+    UI_NODES_LAID_OUT,
+    TEXT_MESHES_REBUILT,
+    INSTANCES_DRAWN,
+    BUILTIN_COUNT
+};
+
+class FrameStats {
+   public:
+    using StatId = std::uint32_t;
+    using Value = std::int64_t;
+
+    static constexpr std::size_t HISTORY_SIZE = 120;
+
+    FrameStats() {
+        registerStat("draw_calls", StatKind::COUNTER);
+        registerStat("shader_switches", StatKind::COUNTER);
+        registerStat("material_switches", StatKind::COUNTER);
+        registerStat("gl_state_changes", StatKind::COUNTER);
+        registerStat("bytes_uploaded", StatKind::COUNTER);
+        registerStat("visible_items", StatKind::COUNTER);
+        registerStat("culled_items", StatKind::COUNTER);
+        registerStat("entity_count", StatKind::GAUGE);
+        registerStat("query_iterations", StatKind::COUNTER);
+        registerStat("ui_nodes_laid_out", StatKind::COUNTER);
+        registerStat("text_meshes_rebuilt", StatKind::COUNTER);
+        registerStat("instances_drawn", StatKind::COUNTER);
+    }
+
+    // registers a custom stat, or returns the existing id if the name is already taken
+    StatId registerStat(std::string_view name, StatKind kind) {
+        for (StatId id = 0; id < _infos.size(); ++id) {
+            if (_infos[id].name == name)
+                return id;
+        }
+
+        _infos.push_back(StatInfo{std::string(name), kind});
+        _current.push_back(0);
+        _history.resize(_infos.size() * HISTORY_SIZE, 0);
+        return static_cast<StatId>(_infos.size() - 1);
+    }
+
+    void add(Stat stat, Value amount = 1) {
+        _current[static_cast<StatId>(stat)] += amount;
+    }
+
+    void add(StatId id, Value amount = 1) {
+        _current[id] += amount;
+    }
+
+    void set(Stat stat, Value value) {
+        _current[static_cast<StatId>(stat)] = value;
+    }
+
+    void set(StatId id, Value value) {
+        _current[id] = value;
+    }
+
+    // pushes this frame's values into the history and resets the counters
+    void endFrame() {
+        _cursor = (_cursor + 1) % HISTORY_SIZE;
+        _recordedFrames = std::min(_recordedFrames + 1, HISTORY_SIZE);
+
+        for (StatId id = 0; id < _infos.size(); ++id) {
+            _history[id * HISTORY_SIZE + _cursor] = _current[id];
+            if (_infos[id].kind == StatKind::COUNTER)
+                _current[id] = 0;
+        }
+    }
+
+    // value accumulated so far in the frame that's in progress
+    Value current(Stat stat) const {
+        return _current[static_cast<StatId>(stat)];
+    }
+
+    Value current(StatId id) const {
+        return _current[id];
+    }
+
+    // value of the last completed frame
+    Value last(Stat stat) const {
+        return last(static_cast<StatId>(stat));
+    }
+
+    Value last(StatId id) const {
+        return history(id, 0);
+    }
+
+    // framesAgo = 0 is the last completed frame
+    Value history(StatId id, std::size_t framesAgo) const {
+        if (framesAgo >= _recordedFrames)
+            return 0;
+        std::size_t slot = (_cursor + HISTORY_SIZE - framesAgo) % HISTORY_SIZE;
+        return _history[id * HISTORY_SIZE + slot];
+    }
+
+    double average(Stat stat) const {
+        return average(static_cast<StatId>(stat));
+    }
+
+    double average(StatId id) const {
+        if (_recordedFrames == 0)
+            return 0.0;
+
+        Value sum = 0;
+        for (std::size_t i = 0; i < _recordedFrames; ++i) {
+            sum += history(id, i);
+        }
+        return static_cast<double>(sum) / static_cast<double>(_recordedFrames);
+    }
+
+    Value max(Stat stat) const {
+        return max(static_cast<StatId>(stat));
+    }
+
+    Value max(StatId id) const {
+        Value result = 0;
+        for (std::size_t i = 0; i < _recordedFrames; ++i) {
+            result = std::max(result, history(id, i));
+        }
+        return result;
+    }
+
+    std::size_t recordedFrames() const {
+        return _recordedFrames;
+    }
+
+    std::size_t count() const {
+        return _infos.size();
+    }
+
+    std::string_view name(StatId id) const {
+        return _infos[id].name;
+    }
+
+    StatKind kind(StatId id) const {
+        return _infos[id].kind;
+    }
+
+   private:
+    struct StatInfo {
+        std::string name;
+        StatKind kind;
+    };
+
+    std::vector<StatInfo> _infos;
+    std::vector<Value> _current;
+    // HISTORY_SIZE consecutive slots per stat, written as a ring at _cursor
+    std::vector<Value> _history;
+    std::size_t _cursor{0};
+    std::size_t _recordedFrames{0};
+};
+
+}  // namespace okay
+
+#endif  // __STATS_H__
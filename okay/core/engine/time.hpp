@@ -2,6 +2,7 @@
 #define __TIME_H__
 
 #include <chrono>
+#include <cstdint>
 
 namespace okay {
 
@@ -17,6 +18,17 @@ class Time {
         _deltaTime = 0;
     }
 
+    // replaces the wall clock until the next call, used by record/replay
+    void drive(std::uint32_t deltaMs, std::uint32_t sinceStartMs) {
+        _deltaTime = deltaMs;
+        _drivenSinceStartMs = sinceStartMs;
+        _driven = true;
+    }
+
+    bool driven() const {
+        return _driven;
+    }
+
     std::uint32_t deltaTimeMs() const {
         return _deltaTime;
     }
@@ -25,6 +37,13 @@ class Time {
     }
 
     std::uint32_t timeSinceStartMs() const {
+        if (_driven)
+            return _drivenSinceStartMs;
+        return wallTimeSinceStartMs();
+    }
+
+    // ignores drive()
+    std::uint32_t wallTimeSinceStartMs() const {
         return std::chrono::duration_cast<std::chrono::milliseconds>(
             HighResClock::now() - _startOfProgram)
             .count();
@@ -48,6 +67,8 @@ class Time {
     TimePoint _lastTime;
     TimePoint _startOfProgram;
     std::uint32_t _deltaTime;
+    std::uint32_t _drivenSinceStartMs{0};
+    bool _driven{false};
 };
 
 }  // namespace okay
@@ -0,0 +1,222 @@
+#include "aabb_tree.hpp"
+
+#include <algorithm>
+#include <utility>
+
+using namespace okay;
+
+AABBTree::Proxy AABBTree::allocateNode() {
+    if (_freeList == NULL_NODE) {
+        _nodes.emplace_back();
+        return static_cast<Proxy>(_nodes.size() - 1);
+    }
+
+    // free nodes are chained through parent
+    Proxy index = _freeList;
+    _freeList = _nodes[index].parent;
+    _nodes[index] = Node{};
+    return index;
+}
+
+void AABBTree::freeNode(Proxy index) {
+    _nodes[index].parent = _freeList;
+    _nodes[index].height = -1;
+    _freeList = index;
+}
+
+AABBTree::Proxy AABBTree::insert(const Bounds& bounds, std::uint32_t userData) {
+    Proxy leaf = allocateNode();
+    _nodes[leaf].bounds = bounds.expanded(_margin);
+    _nodes[leaf].userData = userData;
+    insertLeaf(leaf);
+    ++_leafCount;
+    return leaf;
+}
+
+void AABBTree::remove(Proxy proxy) {
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --_leafCount;
+}
+
+bool AABBTree::move(Proxy proxy, const Bounds& bounds) {
+    if (_nodes[proxy].bounds.contains(bounds))
+        return false;
+
+    removeLeaf(proxy);
+    _nodes[proxy].bounds = bounds.expanded(_margin);
+    insertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::splitFrustumQuery(
+    const Frustum& frustum, int depth, std::vector<Proxy>& pieces) const {
+    FrameVector<std::pair<Proxy, int>> stack(&FrameArena::local());
+    if (_root != NULL_NODE)
+        stack.emplace_back(_root, 0);
+    while (!stack.empty()) {
+        auto [index, level] = stack.back();
+        stack.pop_back();
+
+        const Node& node = _nodes[index];
+        Frustum::Containment containment = frustum.classify(node.bounds);
+        if (containment == Frustum::Containment::OUTSIDE)
+            continue;
+        // the query classifies a piece's root again, which is cheap next to walking it
+        if (containment == Frustum::Containment::INSIDE || node.isLeaf() || level == depth) {
+            pieces.push_back(index);
+        } else {
+            stack.emplace_back(node.child1, level + 1);
+            stack.emplace_back(node.child2, level + 1);
+        }
+    }
+}
+
+void AABBTree::insertLeaf(Proxy leaf) {
+    if (_root == NULL_NODE) {
+        _root = leaf;
+        _nodes[leaf].parent = NULL_NODE;
+        return;
+    }
+
+    // walk down to the sibling whose merged box adds the least area, a child is only worth
+    // descending into while pushing the leaf further down is cheaper than pairing it here
+    const Bounds leafBounds = _nodes[leaf].bounds;
+    Proxy index = _root;
+    while (!_nodes[index].isLeaf()) {
+        const Node& node = _nodes[index];
+        float area = node.bounds.surfaceArea();
+        float combinedArea = Bounds::merge(node.bounds, leafBounds).surfaceArea();
+
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](Proxy child) {
+            const Bounds& childBounds = _nodes[child].bounds;
+            float merged = Bounds::merge(childBounds, leafBounds).surfaceArea();
+            if (_nodes[child].isLeaf())
+                return merged + inheritanceCost;
+            return merged - childBounds.surfaceArea() + inheritanceCost;
+        };
+        float cost1 = descendCost(node.child1);
+        float cost2 = descendCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    Proxy sibling = index;
+    Proxy oldParent = _nodes[sibling].parent;
+    Proxy newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].bounds = Bounds::merge(leafBounds, _nodes[sibling].bounds);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent == NULL_NODE) {
+        _root = newParent;
+    } else if (_nodes[oldParent].child1 == sibling) {
+        _nodes[oldParent].child1 = newParent;
+    } else {
+        _nodes[oldParent].child2 = newParent;
+    }
+
+    refitUpwards(_nodes[leaf].parent);
+}
+
+void AABBTree::removeLeaf(Proxy leaf) {
+    if (leaf == _root) {
+        _root = NULL_NODE;
+        return;
+    }
+
+    Proxy parent = _nodes[leaf].parent;
+    Proxy grandParent = _nodes[parent].parent;
+    Proxy sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    // the sibling takes the parent's place
+    if (grandParent == NULL_NODE) {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_NODE;
+        freeNode(parent);
+        return;
+    }
+
+    if (_nodes[grandParent].child1 == parent)
+        _nodes[grandParent].child1 = sibling;
+    else
+        _nodes[grandParent].child2 = sibling;
+    _nodes[sibling].parent = grandParent;
+    freeNode(parent);
+
+    refitUpwards(grandParent);
+}
+
+void AABBTree::refitUpwards(Proxy index) {
+    while (index != NULL_NODE) {
+        index = balance(index);
+
+        Node& node = _nodes[index];
+        const Node& child1 = _nodes[node.child1];
+        const Node& child2 = _nodes[node.child2];
+        node.height = 1 + std::max(child1.height, child2.height);
+        node.bounds = Bounds::merge(child1.bounds, child2.bounds);
+
+        index = node.parent;
+    }
+}
+
+// rotates the taller child of a up when the heights differ by more than one, returns the node
+// that now sits where a was
+AABBTree::Proxy AABBTree::balance(Proxy iA) {
+    if (_nodes[iA].isLeaf() || _nodes[iA].height < 2)
+        return iA;
+
+    Proxy iB = _nodes[iA].child1;
+    Proxy iC = _nodes[iA].child2;
+    std::int32_t heightDiff = _nodes[iC].height - _nodes[iB].height;
+    if (heightDiff > 1)
+        return rotateUp(iA, iC, iB, true);
+    if (heightDiff < -1)
+        return rotateUp(iA, iB, iC, false);
+    return iA;
+}
+
+// c moves into a's place, a becomes c's first child and takes over c's shorter child in the
+// slot c used to fill, b stays under a
+AABBTree::Proxy AABBTree::rotateUp(Proxy iA, Proxy iC, Proxy iB, bool cWasChild2) {
+    Node& a = _nodes[iA];
+    Node& b = _nodes[iB];
+    Node& c = _nodes[iC];
+    Proxy iKeep = _nodes[c.child1].height > _nodes[c.child2].height ? c.child1 : c.child2;
+    Proxy iMove = iKeep == c.child1 ? c.child2 : c.child1;
+
+    c.child1 = iA;
+    c.child2 = iKeep;
+    c.parent = a.parent;
+    a.parent = iC;
+
+    if (c.parent == NULL_NODE) {
+        _root = iC;
+    } else if (_nodes[c.parent].child1 == iA) {
+        _nodes[c.parent].child1 = iC;
+    } else {
+        _nodes[c.parent].child2 = iC;
+    }
+
+    if (cWasChild2)
+        a.child2 = iMove;
+    else
+        a.child1 = iMove;
+    _nodes[iMove].parent = iA;
+
+    a.bounds = Bounds::merge(b.bounds, _nodes[iMove].bounds);
+    a.height = 1 + std::max(b.height, _nodes[iMove].height);
+    c.bounds = Bounds::merge(a.bounds, _nodes[iKeep].bounds);
+    c.height = 1 + std::max(a.height, _nodes[iKeep].height);
+    return iC;
+}
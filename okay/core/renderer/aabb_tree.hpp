@@ -0,0 +1,187 @@
+#ifndef __AABB_TREE_H__
+#define __AABB_TREE_H__
+
+#include <okay/core/renderer/math_types.hpp>
+#include <okay/core/util/frame_arena.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace okay {
+
+// Dynamic AABB tree, leaves are inserted next to the sibling that grows the tree's surface area
+// the least and the tree is kept balanced with rotations on the way up. Leaves store their box
+// expanded by margin, so small moves stay inside it and don't touch the tree.
+class AABBTree {
+   public:
+    using Proxy = std::int32_t;
+    static constexpr Proxy NULL_NODE = -1;
+
+    explicit AABBTree(float margin = 0.0f) : _margin(margin) {}
+
+    Proxy insert(const Bounds& bounds, std::uint32_t userData);
+    void remove(Proxy proxy);
+    // reinserts the leaf when bounds left its fat box, returns whether it did
+    bool move(Proxy proxy, const Bounds& bounds);
+
+    std::uint32_t userData(Proxy proxy) const {
+        return _nodes[proxy].userData;
+    }
+    void setUserData(Proxy proxy, std::uint32_t userData) {
+        _nodes[proxy].userData = userData;
+    }
+    const Bounds& fatBounds(Proxy proxy) const {
+        return _nodes[proxy].bounds;
+    }
+
+    std::size_t size() const {
+        return _leafCount;
+    }
+    int height() const {
+        return _root == NULL_NODE ? 0 : _nodes[_root].height;
+    }
+
+    // fn(userData) for every leaf whose fat box intersects the frustum, subtrees that are
+    // entirely inside are reported without testing their leaves
+    template <typename Fn>
+    void queryFrustum(const Frustum& frustum, Fn&& fn) const {
+        queryFrustum(frustum, _root, fn);
+    }
+
+    // the same, limited to the subtree under root
+    template <typename Fn>
+    void queryFrustum(const Frustum& frustum, Proxy root, Fn&& fn) const {
+        FrameVector<Proxy> stack(&FrameArena::local());
+        if (root != NULL_NODE)
+            stack.push_back(root);
+        while (!stack.empty()) {
+            Proxy index = stack.back();
+            stack.pop_back();
+
+            const Node& node = _nodes[index];
+            Frustum::Containment containment = frustum.classify(node.bounds);
+            if (containment == Frustum::Containment::OUTSIDE)
+                continue;
+            if (containment == Frustum::Containment::INSIDE) {
+                forEachLeaf(index, fn);
+            } else if (node.isLeaf()) {
+                fn(node.userData);
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    // Splits a frustum query into subtrees that can be queried on their own, e.g. by separate
+    // jobs. Walks up to depth levels down, drops subtrees outside the frustum and appends the
+    // roots it stopped at to pieces, a subtree entirely inside or a leaf stops the walk early.
+    // Querying every piece reports the same leaves as one query over the whole tree.
+    void splitFrustumQuery(const Frustum& frustum, int depth, std::vector<Proxy>& pieces) const;
+
+    // fn(userData) for every leaf whose fat box overlaps shape, a Bounds or a Sphere
+    template <typename Shape, typename Fn>
+    void queryOverlap(const Shape& shape, Fn&& fn) const {
+        FrameVector<Proxy> stack(&FrameArena::local());
+        pushRoot(stack);
+        while (!stack.empty()) {
+            Proxy index = stack.back();
+            stack.pop_back();
+
+            const Node& node = _nodes[index];
+            if (!overlaps(shape, node.bounds))
+                continue;
+            if (node.isLeaf()) {
+                fn(node.userData);
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    // fn(userData, distance) for leaves the ray enters within maxDistance, distance is where
+    // it enters the fat box. fn returns the new max distance, return the hit distance to only
+    // keep looking for closer hits or maxDistance to see every hit.
+    template <typename Fn>
+    void raycast(const Ray& ray, float maxDistance, Fn&& fn) const {
+        FrameVector<Proxy> stack(&FrameArena::local());
+        pushRoot(stack);
+        while (!stack.empty()) {
+            Proxy index = stack.back();
+            stack.pop_back();
+
+            const Node& node = _nodes[index];
+            float distance = 0.0f;
+            if (!ray.intersects(node.bounds, maxDistance, distance))
+                continue;
+            if (node.isLeaf()) {
+                maxDistance = fn(node.userData, distance);
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+   private:
+    struct Node {
+        Bounds bounds;
+        Proxy parent{NULL_NODE};
+        Proxy child1{NULL_NODE};
+        Proxy child2{NULL_NODE};
+        // leaves are 0, free nodes -1
+        std::int32_t height{0};
+        std::uint32_t userData{0};
+
+        bool isLeaf() const {
+            return child1 == NULL_NODE;
+        }
+    };
+
+    std::vector<Node> _nodes;
+    Proxy _root{NULL_NODE};
+    Proxy _freeList{NULL_NODE};
+    std::size_t _leafCount{0};
+    float _margin;
+
+    Proxy allocateNode();
+    void freeNode(Proxy index);
+    void insertLeaf(Proxy leaf);
+    void removeLeaf(Proxy leaf);
+    void refitUpwards(Proxy index);
+    Proxy balance(Proxy index);
+    Proxy rotateUp(Proxy iA, Proxy iC, Proxy iB, bool cWasChild2);
+
+    void pushRoot(FrameVector<Proxy>& stack) const {
+        if (_root != NULL_NODE)
+            stack.push_back(_root);
+    }
+
+    template <typename Fn>
+    void forEachLeaf(Proxy root, Fn& fn) const {
+        FrameVector<Proxy> stack(&FrameArena::local());
+        stack.push_back(root);
+        while (!stack.empty()) {
+            const Node& node = _nodes[stack.back()];
+            stack.pop_back();
+            if (node.isLeaf()) {
+                fn(node.userData);
+            } else {
+                stack.push_back(node.child1);
+                stack.push_back(node.child2);
+            }
+        }
+    }
+
+    static bool overlaps(const Bounds& shape, const Bounds& bounds) {
+        return shape.overlaps(bounds);
+    }
+    static bool overlaps(const Sphere& shape, const Bounds& bounds) {
+        return shape.overlaps(bounds);
+    }
+};
+
+}  // namespace okay
+
+#endif  // __AABB_TREE_H__
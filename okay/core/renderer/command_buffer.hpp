@@ -0,0 +1,142 @@
+#ifndef __COMMAND_BUFFER_H__
+#define __COMMAND_BUFFER_H__
+
+#include <okay/core/renderer/instance_buffer.hpp>
+#include <okay/core/renderer/material.hpp>
+#include <okay/core/renderer/mesh.hpp>
+#include <okay/core/renderer/render_world.hpp>
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace okay {
+
+// fixed function state of a draw packed into a byte, so the executor compares it in one go
+struct RenderState {
+    static constexpr std::uint8_t CULL_BACK = 1 << 0;
+    static constexpr std::uint8_t BLEND = 1 << 1;
+    static constexpr std::uint8_t DEPTH_TEST = 1 << 2;
+    static constexpr std::uint8_t DEPTH_WRITE = 1 << 3;
+
+    std::uint8_t bits{CULL_BACK | DEPTH_TEST | DEPTH_WRITE};
+
+    static RenderState fromMaterialFlags(MaterialFlagCollection flags) {
+        RenderState state{0};
+        if (!flags.hasFlag(MaterialFlags::DOUBLE_SIDED))
+            state.bits |= CULL_BACK;
+        // transparent surfaces blend over what is behind them without hiding it
+        state.bits |= flags.hasFlag(MaterialFlags::TRANSPARENT) ? BLEND : DEPTH_WRITE;
+        if (!flags.hasFlag(MaterialFlags::SCREEN_SPACE))
+            state.bits |= DEPTH_TEST;
+        return state;
+    }
+
+    bool operator==(const RenderState& other) const {
+        return bits == other.bits;
+    }
+    bool operator!=(const RenderState& other) const {
+        return bits != other.bits;
+    }
+};
+
+enum class RenderCommandType : std::uint8_t { CLEAR, DRAW };
+
+struct RenderCommand {
+    std::uint64_t key{0};
+    RenderCommandType type{RenderCommandType::DRAW};
+    RenderState state{};
+    std::uint32_t material{Material::invalidID()};
+    // DRAW: index of the first instance in instances(), CLEAR: index into clearColors()
+    std::uint32_t payload{0};
+    std::uint32_t indexOffset{0};
+    std::uint32_t indexCount{0};
+    // DRAW: consecutive instances starting at payload
+    std::uint32_t instanceCount{1};
+};
+
+static_assert(sizeof(RenderCommand) == 32, "RenderCommand should stay 32 bytes");
+
+// what every material switch needs to know about the view being drawn
+struct RenderView {
+    glm::mat4 projection{1.0f};
+    glm::mat4 view{1.0f};
+    glm::mat4 screenSpaceProjection{1.0f};
+    glm::vec3 cameraPosition{0.0f};
+    glm::vec3 cameraDirection{0.0f, 0.0f, -1.0f};
+    float timeMs{0.0f};
+    std::span<const Light> lights;
+};
+
+// A list of draws with everything the executor needs copied in, so it can be recorded on any
+// thread without touching GL. Several buffers can be recorded in parallel and executed one after
+// the other. reset() keeps the memory for the next frame.
+class RenderCommandBuffer {
+   public:
+    void reset() {
+        _commands.clear();
+        _instances.clear();
+        _clearColors.clear();
+    }
+
+    void clear(const glm::vec4& color, std::uint64_t key = 0) {
+        RenderCommand command;
+        command.key = key;
+        command.type = RenderCommandType::CLEAR;
+        command.payload = static_cast<std::uint32_t>(_clearColors.size());
+        _clearColors.push_back(color);
+        _commands.push_back(command);
+    }
+
+    void draw(std::uint64_t key,
+        const MaterialHandle& material,
+        const Mesh& mesh,
+        const glm::mat4& model,
+        const glm::vec4& tint = glm::vec4(1.0f)) {
+        // the mesh drawn again right after itself with the same material is one more instance
+        if (!_commands.empty()) {
+            RenderCommand& last = _commands.back();
+            if (last.type == RenderCommandType::DRAW && last.key == key &&
+                last.material == material.id && last.indexOffset == mesh.indexOffset &&
+                last.indexCount == mesh.indexCount) {
+                ++last.instanceCount;
+                _instances.push_back(InstanceData::from(model, tint));
+                return;
+            }
+        }
+
+        RenderCommand command;
+        command.key = key;
+        command.type = RenderCommandType::DRAW;
+        command.state = RenderState::fromMaterialFlags(material->properties()->flags());
+        command.material = material.id;
+        command.payload = static_cast<std::uint32_t>(_instances.size());
+        command.indexOffset = static_cast<std::uint32_t>(mesh.indexOffset);
+        command.indexCount = static_cast<std::uint32_t>(mesh.indexCount);
+        _instances.push_back(InstanceData::from(model, tint));
+        _commands.push_back(command);
+    }
+
+    std::span<const RenderCommand> commands() const {
+        return _commands;
+    }
+    std::span<const InstanceData> instances() const {
+        return _instances;
+    }
+    std::span<const glm::vec4> clearColors() const {
+        return _clearColors;
+    }
+    bool empty() const {
+        return _commands.empty();
+    }
+
+   private:
+    std::vector<RenderCommand> _commands;
+    std::vector<InstanceData> _instances;
+    std::vector<glm::vec4> _clearColors;
+};
+
+}  // namespace okay
+
+#endif  // __COMMAND_BUFFER_H__
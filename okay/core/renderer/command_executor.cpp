@@ -0,0 +1,161 @@
+#include "command_executor.hpp"
+
+#include <okay/core/renderer/gpu.hpp>
+#include <okay/core/renderer/materials/unlit.hpp>
+
+#include <algorithm>
+
+using namespace okay;
+
+void GLCommandExecutor::begin(const RenderView& view) {
+    _view = view;
+    _material = Material::invalidID();
+    _shader = Shader::invalidID();
+    _stateKnown = false;
+    _instanced = false;
+    _materialReady = false;
+    _instances.begin();
+
+    if (Failable f = _frame.update(view); f.isError())
+        Engine.logger.error("Failed to upload frame uniforms : {}", f.error());
+
+    // doesn't need MSAA, but should if the platform can support it
+    GPUState::instance().gl.setEnabled(GL_MULTISAMPLE, true);
+}
+
+void GLCommandExecutor::execute(
+    const RenderCommandBuffer& buffer, MeshBuffer& meshes, MaterialRegistry& materials) {
+    stageInstances(buffer);
+
+    std::span<const RenderCommand> commands = buffer.commands();
+    std::span<const InstanceData> instances = buffer.instances();
+    for (std::size_t i = 0; i < commands.size(); ++i) {
+        const RenderCommand& command = commands[i];
+        if (command.type == RenderCommandType::CLEAR) {
+            clear(buffer.clearColors()[command.payload]);
+            continue;
+        }
+
+        const std::unique_ptr<Material>& material = materials.getMaterial(command.material);
+        if (_material != command.material) {
+            _materialReady = switchMaterial(*material);
+            _material = command.material;
+        }
+        // without its shader the draws would run with whatever program was bound before
+        if (!_materialReady)
+            continue;
+
+        applyState(command.state);
+
+        // the material's own uniforms went up when it was switched to, per object data is in
+        // the instances block
+        if (_instanced) {
+            // the block holds MAX_INSTANCES, longer runs take a draw per block
+            for (std::uint32_t first = 0; first < command.instanceCount;
+                first += InstanceBuffer::MAX_INSTANCES) {
+                std::uint32_t count =
+                    std::min(command.instanceCount - first, InstanceBuffer::MAX_INSTANCES);
+                _instances.bind(_instanceOffsets[i] + first);
+                meshes.drawElementsInstanced(command.indexOffset, command.indexCount, count);
+            }
+            continue;
+        }
+
+        // shaders without the block take the model matrix and tint as uniforms, set per draw
+        for (std::uint32_t instance = 0; instance < command.instanceCount; ++instance) {
+            const InstanceData& data = instances[command.payload + instance];
+            _program->setUniform(_modelMatrixSlot, data.model);
+            _program->setUniform(_tintSlot, data.tint);
+            meshes.drawElements(command.indexOffset, command.indexCount);
+        }
+    }
+}
+
+void GLCommandExecutor::stageInstances(const RenderCommandBuffer& buffer) {
+    // every draw is staged, whether its shader is instanced is only known once it's compiled
+    std::span<const InstanceData> instances = buffer.instances();
+    _instanceOffsets.clear();
+    for (const RenderCommand& command : buffer.commands()) {
+        if (command.type != RenderCommandType::DRAW) {
+            _instanceOffsets.push_back(0);
+            continue;
+        }
+        _instanceOffsets.push_back(
+            _instances.stage(instances.subspan(command.payload, command.instanceCount)));
+    }
+
+    if (Failable f = _instances.upload(); f.isError())
+        Engine.logger.error("Failed to upload instances : {}", f.error());
+}
+
+void GLCommandExecutor::clear(const glm::vec4& color) {
+    // the depth mask applies to clears too
+    GL_CHECK(GPUState::instance().gl.depthMask(true));
+    GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
+    GL_CHECK(glClearColor(color.r, color.g, color.b, color.a));
+    GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
+    _state.bits |= RenderState::DEPTH_WRITE;
+}
+
+bool GLCommandExecutor::switchMaterial(Material& material) {
+    Engine.stats.add(Stat::MATERIAL_SWITCHES);
+
+    if (_shader != material.shaderID()) {
+        if (auto f = material.setShader(); f.isError()) {
+            Engine.logger.error("Failed to set shader : {}", f.error());
+            _shader = Shader::invalidID();
+            _instanced = false;
+            return false;
+        }
+        _shader = material.shaderID();
+        _instanced = material.isInstanced();
+        _program = material.shader();
+        if (!_instanced) {
+            _modelMatrixSlot = _program->resolveUniformSlot("u_modelMatrix");
+            _tintSlot = _program->resolveUniformSlot("u_tint", true);
+        }
+    }
+
+    auto& properties = material.properties();
+    bool screenSpace = properties->flags().hasFlag(MaterialFlags::SCREEN_SPACE);
+
+    if (material.usesSharedView()) {
+        _frame.bindView(screenSpace ? FrameUniforms::View::SCREEN : FrameUniforms::View::WORLD);
+    } else if (SceneMaterialProperties* sceneProps = material.pipeline().scene) {
+        // shaders without the view block take the camera as uniforms
+        if (screenSpace) {
+            sceneProps->projectionMatrix.set(_view.screenSpaceProjection);
+            sceneProps->viewMatrix.set(glm::identity<glm::mat4>());
+        } else {
+            sceneProps->projectionMatrix.set(_view.projection);
+            sceneProps->viewMatrix.set(_view.view);
+        }
+        sceneProps->cameraPosition.set(_view.cameraPosition);
+        sceneProps->cameraDirection.set(_view.cameraDirection);
+        sceneProps->timeMs.set(_view.timeMs);
+    }
+
+    // once per switch, draws with this material only change per object data
+    if (Failable f = material.passUniforms(); f.isError())
+        Engine.logger.error("Failed to pass uniforms : {}", f.error());
+    return true;
+}
+
+void GLCommandExecutor::applyState(RenderState state) {
+    // most draws share the previous draw's state, the cache filters the rest per call
+    if (_stateKnown && state == _state)
+        return;
+
+    GLStateCache& gl = GPUState::instance().gl;
+    gl.setEnabled(GL_CULL_FACE, state.bits & RenderState::CULL_BACK);
+    if (state.bits & RenderState::CULL_BACK)
+        gl.cullFace(GL_BACK);
+    gl.setEnabled(GL_BLEND, state.bits & RenderState::BLEND);
+    if (state.bits & RenderState::BLEND)
+        gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl.depthMask(state.bits & RenderState::DEPTH_WRITE);
+    gl.setEnabled(GL_DEPTH_TEST, state.bits & RenderState::DEPTH_TEST);
+
+    _state = state;
+    _stateKnown = true;
+}
@@ -0,0 +1,57 @@
+#ifndef __COMMAND_EXECUTOR_H__
+#define __COMMAND_EXECUTOR_H__
+
+#include <okay/core/renderer/command_buffer.hpp>
+#include <okay/core/renderer/frame_uniforms.hpp>
+#include <okay/core/renderer/gl.hpp>
+#include <okay/core/renderer/instance_buffer.hpp>
+#include <okay/core/renderer/material.hpp>
+#include <okay/core/renderer/mesh.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace okay {
+
+// Translates recorded command buffers to GL on the GL thread. It remembers the material, shader
+// and fixed function state of the last command and skips what the next one doesn't change, the
+// GLStateCache below it drops whatever is still redundant. Shaders with the instances block draw a
+// command's instances in one call, others get a draw per instance that only sets its model matrix
+// and tint. Camera, time and lights go up once per frame in FrameUniforms, only shaders that don't
+// read its blocks get them per material.
+class GLCommandExecutor {
+   public:
+    // starts a frame, the material and state of the last frame's commands are forgotten
+    void begin(const RenderView& view);
+    void execute(
+        const RenderCommandBuffer& buffer, MeshBuffer& meshes, MaterialRegistry& materials);
+
+   private:
+    RenderView _view;
+    std::uint32_t _material{Material::invalidID()};
+    std::uint32_t _shader{Shader::invalidID()};
+    RenderState _state;
+    bool _stateKnown{false};
+    bool _instanced{false};
+    bool _materialReady{false};
+    // per draw uniforms of the current shader when it has no instances block
+    Shader* _program{nullptr};
+    Shader::UniformSlot _modelMatrixSlot{0};
+    Shader::UniformSlot _tintSlot{0};
+
+    FrameUniforms _frame;
+    InstanceBuffer _instances;
+    // staged offset of every command's matrices
+    std::vector<std::size_t> _instanceOffsets;
+
+    void stageInstances(const RenderCommandBuffer& buffer);
+    void clear(const glm::vec4& color);
+    // false if the material's shader couldn't be used, its draws are skipped
+    bool switchMaterial(Material& material);
+    void applyState(RenderState state);
+};
+
+}  // namespace okay
+
+#endif  // __COMMAND_EXECUTOR_H__
@@ -0,0 +1,127 @@
+#include "culling.hpp"
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define OKAY_CULL_SSE 1
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define OKAY_CULL_NEON 1
+#include <arm_neon.h>
+#endif
+
+using namespace okay;
+
+namespace {
+
+// a plane splatted for the simd loop, |n| is precomputed for the extent projection
+struct CullPlane {
+    float nx, ny, nz, d;
+    float ax, ay, az;
+};
+
+bool isInside(const CullPlane* planes, const glm::vec3& c, const glm::vec3& e) {
+    for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+        const CullPlane& plane = planes[p];
+        float s = plane.nx * c.x + plane.ny * c.y + plane.nz * c.z + plane.d;
+        float r = plane.ax * e.x + plane.ay * e.y + plane.az * e.z;
+        if (s + r < 0.0f)
+            return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+void okay::cullBounds(const Frustum& frustum,
+    const CullBounds& bounds,
+    std::uint32_t begin,
+    std::uint32_t end,
+    std::vector<std::uint32_t>& visible) {
+    CullPlane planes[Frustum::PLANE_COUNT];
+    for (int p = 0; p < Frustum::PLANE_COUNT; ++p) {
+        const glm::vec4& plane = frustum.planes[p];
+        planes[p] = CullPlane{plane.x,
+            plane.y,
+            plane.z,
+            plane.w,
+            std::abs(plane.x),
+            std::abs(plane.y),
+            std::abs(plane.z)};
+    }
+
+    const float* cx = bounds._centerX.data();
+    const float* cy = bounds._centerY.data();
+    const float* cz = bounds._centerZ.data();
+    const float* ex = bounds._extentX.data();
+    const float* ey = bounds._extentY.data();
+    const float* ez = bounds._extentZ.data();
+
+    std::uint32_t i = begin;
+
+    // a box is outside once s + r < 0 for any plane, where s is the center's distance and r
+    // the extents projected onto the normal, four boxes per iteration
+#if defined(OKAY_CULL_SSE)
+    for (; i + 4 <= end; i += 4) {
+        __m128 x = _mm_loadu_ps(cx + i);
+        __m128 y = _mm_loadu_ps(cy + i);
+        __m128 z = _mm_loadu_ps(cz + i);
+        __m128 hx = _mm_loadu_ps(ex + i);
+        __m128 hy = _mm_loadu_ps(ey + i);
+        __m128 hz = _mm_loadu_ps(ez + i);
+
+        __m128 outside = _mm_setzero_ps();
+        for (const CullPlane& plane : planes) {
+            __m128 s = _mm_set1_ps(plane.d);
+            s = _mm_add_ps(s, _mm_mul_ps(x, _mm_set1_ps(plane.nx)));
+            s = _mm_add_ps(s, _mm_mul_ps(y, _mm_set1_ps(plane.ny)));
+            s = _mm_add_ps(s, _mm_mul_ps(z, _mm_set1_ps(plane.nz)));
+            s = _mm_add_ps(s, _mm_mul_ps(hx, _mm_set1_ps(plane.ax)));
+            s = _mm_add_ps(s, _mm_mul_ps(hy, _mm_set1_ps(plane.ay)));
+            s = _mm_add_ps(s, _mm_mul_ps(hz, _mm_set1_ps(plane.az)));
+            outside = _mm_or_ps(outside, _mm_cmplt_ps(s, _mm_setzero_ps()));
+        }
+
+        int mask = ~_mm_movemask_ps(outside) & 0xF;
+        for (std::uint32_t lane = 0; lane < 4; ++lane) {
+            if (mask & (1 << lane))
+                visible.push_back(i + lane);
+        }
+    }
+#elif defined(OKAY_CULL_NEON)
+    for (; i + 4 <= end; i += 4) {
+        float32x4_t x = vld1q_f32(cx + i);
+        float32x4_t y = vld1q_f32(cy + i);
+        float32x4_t z = vld1q_f32(cz + i);
+        float32x4_t hx = vld1q_f32(ex + i);
+        float32x4_t hy = vld1q_f32(ey + i);
+        float32x4_t hz = vld1q_f32(ez + i);
+
+        uint32x4_t outside = vdupq_n_u32(0);
+        for (const CullPlane& plane : planes) {
+            float32x4_t s = vdupq_n_f32(plane.d);
+            s = vmlaq_n_f32(s, x, plane.nx);
+            s = vmlaq_n_f32(s, y, plane.ny);
+            s = vmlaq_n_f32(s, z, plane.nz);
+            s = vmlaq_n_f32(s, hx, plane.ax);
+            s = vmlaq_n_f32(s, hy, plane.ay);
+            s = vmlaq_n_f32(s, hz, plane.az);
+            outside = vorrq_u32(outside, vcltq_f32(s, vdupq_n_f32(0.0f)));
+        }
+
+        if (vgetq_lane_u32(outside, 0) == 0)
+            visible.push_back(i);
+        if (vgetq_lane_u32(outside, 1) == 0)
+            visible.push_back(i + 1);
+        if (vgetq_lane_u32(outside, 2) == 0)
+            visible.push_back(i + 2);
+        if (vgetq_lane_u32(outside, 3) == 0)
+            visible.push_back(i + 3);
+    }
+#endif
+
+    for (; i < end; ++i) {
+        if (isInside(planes, glm::vec3(cx[i], cy[i], cz[i]), glm::vec3(ex[i], ey[i], ez[i])))
+            visible.push_back(i);
+    }
+}
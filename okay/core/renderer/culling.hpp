@@ -0,0 +1,97 @@
+#ifndef __CULLING_H__
+#define __CULLING_H__
+
+#include <okay/core/renderer/math_types.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace okay {
+
+// World space boxes as centers and half extents with one array per component, so the culling
+// loop tests four boxes against a plane with a handful of simd ops.
+class CullBounds {
+   public:
+    std::size_t size() const {
+        return _centerX.size();
+    }
+
+    void push_back(const Bounds& bounds) {
+        _centerX.emplace_back();
+        _centerY.emplace_back();
+        _centerZ.emplace_back();
+        _extentX.emplace_back();
+        _extentY.emplace_back();
+        _extentZ.emplace_back();
+        set(size() - 1, bounds);
+    }
+
+    void pop_back() {
+        _centerX.pop_back();
+        _centerY.pop_back();
+        _centerZ.pop_back();
+        _extentX.pop_back();
+        _extentY.pop_back();
+        _extentZ.pop_back();
+    }
+
+    // returns whether the stored box changed
+    bool set(std::size_t i, const Bounds& bounds) {
+        glm::vec3 c = bounds.center();
+        glm::vec3 e = bounds.extents();
+        bool changed = _centerX[i] != c.x || _centerY[i] != c.y || _centerZ[i] != c.z ||
+                       _extentX[i] != e.x || _extentY[i] != e.y || _extentZ[i] != e.z;
+        _centerX[i] = c.x;
+        _centerY[i] = c.y;
+        _centerZ[i] = c.z;
+        _extentX[i] = e.x;
+        _extentY[i] = e.y;
+        _extentZ[i] = e.z;
+        return changed;
+    }
+
+    Bounds get(std::size_t i) const {
+        glm::vec3 c(_centerX[i], _centerY[i], _centerZ[i]);
+        glm::vec3 e(_extentX[i], _extentY[i], _extentZ[i]);
+        return Bounds(c - e, c + e);
+    }
+
+    void copy(std::size_t from, std::size_t to) {
+        _centerX[to] = _centerX[from];
+        _centerY[to] = _centerY[from];
+        _centerZ[to] = _centerZ[from];
+        _extentX[to] = _extentX[from];
+        _extentY[to] = _extentY[from];
+        _extentZ[to] = _extentZ[from];
+    }
+
+   private:
+    friend void cullBounds(const Frustum& frustum,
+        const CullBounds& bounds,
+        std::uint32_t begin,
+        std::uint32_t end,
+        std::vector<std::uint32_t>& visible);
+
+    std::vector<float> _centerX;
+    std::vector<float> _centerY;
+    std::vector<float> _centerZ;
+    std::vector<float> _extentX;
+    std::vector<float> _extentY;
+    std::vector<float> _extentZ;
+};
+
+// appends the indices in [begin, end) whose box intersects the frustum to visible, in order
+void cullBounds(const Frustum& frustum,
+    const CullBounds& bounds,
+    std::uint32_t begin,
+    std::uint32_t end,
+    std::vector<std::uint32_t>& visible);
+
+inline void cullBounds(
+    const Frustum& frustum, const CullBounds& bounds, std::vector<std::uint32_t>& visible) {
+    cullBounds(frustum, bounds, 0, static_cast<std::uint32_t>(bounds.size()), visible);
+}
+
+}  // namespace okay
+
+#endif  // __CULLING_H__
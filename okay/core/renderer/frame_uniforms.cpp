@@ -0,0 +1,90 @@
+#include "frame_uniforms.hpp"
+
+#include <okay/core/renderer/gpu.hpp>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace okay;
+
+namespace {
+
+std::size_t alignUp(std::size_t value, std::size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+}  // namespace
+
+FrameUniforms::~FrameUniforms() {
+    if (_buffer)
+        glDeleteBuffers(1, &_buffer);
+}
+
+void FrameUniforms::layout() {
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+    std::size_t align = static_cast<std::size_t>(std::max<GLint>(alignment, 1));
+
+    // the frame block first, then every view on an offset glBindBufferRange accepts
+    std::size_t offset = alignUp(sizeof(FrameData), align);
+    for (std::size_t& viewOffset : _viewOffsets) {
+        viewOffset = offset;
+        offset = alignUp(offset + sizeof(ViewData), align);
+    }
+    _size = offset;
+    _staging.assign(_size, std::byte{0});
+}
+
+Failable FrameUniforms::update(const RenderView& view) {
+    if (_buffer == 0) {
+        GL_CHECK_FAILABLE(glGenBuffers(1, &_buffer));
+        layout();
+    }
+
+    FrameData frame;
+    frame.meta.x = static_cast<float>(view.lights.size());
+    frame.meta.y = view.timeMs;
+    std::copy_n(view.lights.begin(),
+        std::min(view.lights.size(), frame.lights.size()),
+        frame.lights.begin());
+    std::memcpy(_staging.data(), &frame, sizeof(frame));
+
+    ViewData world;
+    world.projection = view.projection;
+    world.view = view.view;
+    world.cameraPosition = glm::vec4(view.cameraPosition, 1.0f);
+    world.cameraDirection = glm::vec4(view.cameraDirection, 0.0f);
+    std::memcpy(_staging.data() + _viewOffsets[static_cast<std::size_t>(View::WORLD)],
+        &world,
+        sizeof(world));
+
+    // screen space draws are placed in pixels by their model matrix alone
+    ViewData screen = world;
+    screen.projection = view.screenSpaceProjection;
+    screen.view = glm::mat4(1.0f);
+    std::memcpy(_staging.data() + _viewOffsets[static_cast<std::size_t>(View::SCREEN)],
+        &screen,
+        sizeof(screen));
+
+    // respecifying the storage orphans last frame's, draws still reading it keep it
+    GL_CHECK_FAILABLE(glBindBuffer(GL_UNIFORM_BUFFER, _buffer));
+    GL_CHECK_FAILABLE(glBufferData(GL_UNIFORM_BUFFER,
+        static_cast<GLsizeiptr>(_size),
+        _staging.data(),
+        GL_STREAM_DRAW));
+    Engine.stats.add(Stat::BYTES_UPLOADED, _size);
+
+    // bindings name the buffer, not its storage, so after the first frame this is a no-op
+    GPUState::instance().gl.bindUniformBufferRange(UniformBindings::FRAME,
+        _buffer,
+        0,
+        static_cast<GLsizeiptr>(sizeof(FrameData)));
+    return Failable::ok({});
+}
+
+void FrameUniforms::bindView(View view) {
+    GPUState::instance().gl.bindUniformBufferRange(UniformBindings::VIEW,
+        _buffer,
+        static_cast<GLintptr>(_viewOffsets[static_cast<std::size_t>(view)]),
+        static_cast<GLsizeiptr>(sizeof(ViewData)));
+}
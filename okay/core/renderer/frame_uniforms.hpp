@@ -0,0 +1,70 @@
+#ifndef __FRAME_UNIFORMS_H__
+#define __FRAME_UNIFORMS_H__
+
+#include <okay/core/renderer/command_buffer.hpp>
+#include <okay/core/renderer/gl.hpp>
+#include <okay/core/renderer/render_world.hpp>
+#include <okay/core/util/result.hpp>
+
+#include <array>
+#include <cstddef>
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace okay {
+
+// what every shader sees the same way all frame, laid out like the std140 u_frame block in the
+// built-in shaders
+struct alignas(16) FrameData {
+    // x = light count, y = time since start in ms
+    glm::vec4 meta{0.0f};
+    std::array<Light, Light::MAX_LIGHTS> lights{};
+};
+
+// the camera a draw is seen through, laid out like the std140 u_view block
+struct alignas(16) ViewData {
+    glm::mat4 projection{1.0f};
+    glm::mat4 view{1.0f};
+    // w unused, vec3 members would pad the same way
+    glm::vec4 cameraPosition{0.0f};
+    glm::vec4 cameraDirection{0.0f, 0.0f, -1.0f, 0.0f};
+};
+
+static_assert(sizeof(FrameData) == 16 + Light::MAX_LIGHTS * 64,
+    "FrameData must match the std140 layout");
+static_assert(sizeof(ViewData) == 160, "ViewData must match the std140 layout");
+
+// Owns the uniform buffer behind the u_frame and u_view blocks. Everything in it is uploaded once
+// per frame in one call, the frame block is bound for the whole frame and switching between the
+// world and screen space views only moves the view block's range. Materials whose shaders read
+// the blocks have nothing camera or light related left to upload on a switch.
+class FrameUniforms {
+   public:
+    static constexpr const char* FRAME_BLOCK_NAME = "u_frame";
+    static constexpr const char* VIEW_BLOCK_NAME = "u_view";
+
+    enum class View { WORLD, SCREEN, COUNT };
+
+    FrameUniforms() = default;
+    ~FrameUniforms();
+
+    FrameUniforms(const FrameUniforms&) = delete;
+    FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+    // uploads the frame and both views, then binds the frame block
+    Failable update(const RenderView& view);
+    // points the view block at one of the views uploaded by update()
+    void bindView(View view);
+
+   private:
+    GLuint _buffer{0};
+    std::size_t _size{0};
+    std::array<std::size_t, static_cast<std::size_t>(View::COUNT)> _viewOffsets{};
+    std::vector<std::byte> _staging;
+
+    void layout();
+};
+
+}  // namespace okay
+
+#endif  // __FRAME_UNIFORMS_H__
@@ -0,0 +1,196 @@
+#ifndef __GL_STATE_H__
+#define __GL_STATE_H__
+
+#include <okay/core/engine/engine.hpp>
+#include <okay/core/renderer/gl.hpp>
+
+#include <array>
+#include <cstdint>
+
+namespace okay {
+
+// Shadows the GL state the renderer changes and drops calls that would set what is already set.
+// Everything that changes this state has to go through here for the shadow to stay right, code
+// that can't, like the imgui backend, is followed by invalidate(). The setters return whether
+// they issued a call.
+class GLStateCache {
+   public:
+    static constexpr std::size_t TEXTURE_UNITS = 16;
+    static constexpr std::size_t UNIFORM_BUFFER_BINDINGS = 16;
+
+    GLStateCache() {
+        invalidate();
+    }
+
+    // forgets everything, the next call of every kind goes through
+    void invalidate() {
+        _capabilities.fill(UNKNOWN);
+        _depthMask = UNKNOWN;
+        _blendSrc = UNKNOWN_NAME;
+        _blendDst = UNKNOWN_NAME;
+        _cullFace = UNKNOWN_NAME;
+        _program = UNKNOWN_NAME;
+        _vertexArray = UNKNOWN_NAME;
+        _activeTexture = UNKNOWN_NAME;
+        _textures.fill(UNKNOWN_NAME);
+        _uniformBuffers.fill(UniformBufferRange{UNKNOWN_NAME, 0, 0});
+    }
+
+    bool setEnabled(GLenum capability, bool enabled) {
+        std::size_t index = capabilityIndex(capability);
+        if (index < _capabilities.size()) {
+            if (_capabilities[index] == enabled)
+                return false;
+            _capabilities[index] = enabled;
+        }
+        if (enabled)
+            glEnable(capability);
+        else
+            glDisable(capability);
+        return changed();
+    }
+
+    bool depthMask(bool enabled) {
+        if (_depthMask == enabled)
+            return false;
+        _depthMask = enabled;
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+        return changed();
+    }
+
+    bool blendFunc(GLenum src, GLenum dst) {
+        if (_blendSrc == src && _blendDst == dst)
+            return false;
+        _blendSrc = src;
+        _blendDst = dst;
+        glBlendFunc(src, dst);
+        return changed();
+    }
+
+    bool cullFace(GLenum face) {
+        if (_cullFace == face)
+            return false;
+        _cullFace = face;
+        glCullFace(face);
+        return changed();
+    }
+
+    bool useProgram(GLuint program) {
+        if (_program == program)
+            return false;
+        _program = program;
+        glUseProgram(program);
+        return changed();
+    }
+
+    bool bindVertexArray(GLuint vertexArray) {
+        if (_vertexArray == vertexArray)
+            return false;
+        _vertexArray = vertexArray;
+        glBindVertexArray(vertexArray);
+        return changed();
+    }
+
+    bool activeTexture(GLuint unit) {
+        if (_activeTexture == unit)
+            return false;
+        _activeTexture = unit;
+        glActiveTexture(GL_TEXTURE0 + unit);
+        return changed();
+    }
+
+    // leaves unit as the active texture unit
+    bool bindTexture2D(GLuint unit, GLuint texture) {
+        bool issued = activeTexture(unit);
+        if (unit < TEXTURE_UNITS) {
+            if (_textures[unit] == texture)
+                return issued;
+            _textures[unit] = texture;
+        }
+        glBindTexture(GL_TEXTURE_2D, texture);
+        return changed();
+    }
+
+    // glBindBufferBase also binds the buffer to GL_UNIFORM_BUFFER, which isn't tracked
+    bool bindUniformBuffer(GLuint bindingPoint, GLuint buffer) {
+        if (bindingPoint < UNIFORM_BUFFER_BINDINGS) {
+            UniformBufferRange whole{buffer, 0, WHOLE_BUFFER};
+            if (_uniformBuffers[bindingPoint] == whole)
+                return false;
+            _uniformBuffers[bindingPoint] = whole;
+        }
+        glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer);
+        return changed();
+    }
+
+    // same as above for glBindBufferRange
+    bool bindUniformBufferRange(
+        GLuint bindingPoint, GLuint buffer, GLintptr offset, GLsizeiptr size) {
+        if (bindingPoint < UNIFORM_BUFFER_BINDINGS) {
+            UniformBufferRange range{buffer, offset, size};
+            if (_uniformBuffers[bindingPoint] == range)
+                return false;
+            _uniformBuffers[bindingPoint] = range;
+        }
+        glBindBufferRange(GL_UNIFORM_BUFFER, bindingPoint, buffer, offset, size);
+        return changed();
+    }
+
+    GLuint program() const {
+        return _program;
+    }
+
+   private:
+    static constexpr std::int8_t UNKNOWN = -1;
+    // no object or enum has this name, so it never matches a real one
+    static constexpr GLuint UNKNOWN_NAME = 0xFFFFFFFFu;
+    static constexpr GLsizeiptr WHOLE_BUFFER = -1;
+
+    struct UniformBufferRange {
+        GLuint buffer;
+        GLintptr offset;
+        GLsizeiptr size;
+
+        bool operator==(const UniformBufferRange& other) const {
+            return buffer == other.buffer && offset == other.offset && size == other.size;
+        }
+    };
+
+    std::array<std::int8_t, 5> _capabilities{};
+    std::int8_t _depthMask{UNKNOWN};
+    GLenum _blendSrc{UNKNOWN_NAME};
+    GLenum _blendDst{UNKNOWN_NAME};
+    GLenum _cullFace{UNKNOWN_NAME};
+    GLuint _program{UNKNOWN_NAME};
+    GLuint _vertexArray{UNKNOWN_NAME};
+    GLuint _activeTexture{UNKNOWN_NAME};
+    std::array<GLuint, TEXTURE_UNITS> _textures{};
+    std::array<UniformBufferRange, UNIFORM_BUFFER_BINDINGS> _uniformBuffers{};
+
+    // capabilities that aren't tracked always go through
+    static std::size_t capabilityIndex(GLenum capability) {
+        switch (capability) {
+            case GL_CULL_FACE:
+                return 0;
+            case GL_BLEND:
+                return 1;
+            case GL_DEPTH_TEST:
+                return 2;
+            case GL_SCISSOR_TEST:
+                return 3;
+            case GL_MULTISAMPLE:
+                return 4;
+            default:
+                return static_cast<std::size_t>(-1);
+        }
+    }
+
+    static bool changed() {
+        Engine.stats.add(Stat::GL_STATE_CHANGES);
+        return true;
+    }
+};
+
+}  // namespace okay
+
+#endif  // __GL_STATE_H__
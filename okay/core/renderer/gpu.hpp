@@ -3,6 +3,8 @@
 
 #include <okay/core/engine/engine.hpp>
 #include <okay/core/renderer/gl.hpp>
+#include <okay/core/renderer/gl_state.hpp>
+#include <okay/core/renderer/program_cache.hpp>
 #include <okay/core/renderer/texture.hpp>
 #include <okay/core/util/result.hpp>
 
@@ -15,9 +17,17 @@
 
 namespace okay {
 
+// binding points of the engine's own uniform blocks, blocks without a hint are placed after them
+struct UniformBindings {
+    static constexpr GLuint INSTANCES = 1;
+    static constexpr GLuint FRAME = 2;
+    static constexpr GLuint VIEW = 3;
+    static constexpr GLuint RESERVED = 4;
+};
+
 class UniformBlockManager {
    public:
-    UniformBlockManager() = default;
+    explicit UniformBlockManager(GLStateCache& gl) : _gl(gl) {}
     ~UniformBlockManager() {
         destroyAll();
     }
@@ -78,8 +88,8 @@ class UniformBlockManager {
             markBoundToProgram(u, program);
         }
 
-        // Bind buffer to binding point every pass
-        GL_CHECK_FAILABLE(glBindBufferBase(GL_UNIFORM_BUFFER, u.bindingPoint, u.id));
+        // the binding point usually still holds the buffer from the last pass
+        _gl.bindUniformBuffer(u.bindingPoint, u.id);
 
         // Upload only if version changed
         const std::uint32_t v = versionOf(prop);
@@ -89,6 +99,7 @@ class UniformBlockManager {
                 glBufferSubData(GL_UNIFORM_BUFFER, 0, (GLsizeiptr)sizeof(TBlock), &prop.get()));
             GL_CHECK_FAILABLE(glBindBuffer(GL_UNIFORM_BUFFER, 0));
             u.lastUploadedVersion = v;
+            Engine.stats.add(Stat::BYTES_UPLOADED, sizeof(TBlock));
         }
 
         return Failable::ok({});
@@ -108,8 +119,9 @@ class UniformBlockManager {
         std::unordered_map<GLuint, bool> boundPrograms;
     };
 
+    GLStateCache& _gl;
     std::unordered_map<const void*, GpuUbo> _ubos;
-    inline static std::atomic<GLuint> s_nextBindingPoint{0};
+    inline static std::atomic<GLuint> s_nextBindingPoint{UniformBindings::RESERVED};
 
     template <class BlockProp>
     static const void* propKey(const BlockProp& p) {
@@ -159,7 +171,7 @@ class TextureManager {
         bool paramsInitialized = false;
     };
 
-    TextureManager() = default;
+    explicit TextureManager(GLStateCache& gl) : _gl(gl) {}
     ~TextureManager() {
         destroyAll();
     }
@@ -202,7 +214,7 @@ class TextureManager {
             auto data = tex.getData();
 
             GL_CHECK_FAILABLE(glGenTextures(1, &gt.id));
-            GL_CHECK_FAILABLE(glBindTexture(GL_TEXTURE_2D, gt.id));
+            GL_CHECK_FAILABLE(_gl.bindTexture2D(0, gt.id));
             Engine.logger.info(
                 "Uploading texture to GPU: textureId={}, width={}, height={}, format={}",
                 gt.id,
@@ -255,6 +267,7 @@ class TextureManager {
                     glFormat,
                     GL_UNSIGNED_BYTE,
                     data.data()));
+                Engine.stats.add(Stat::BYTES_UPLOADED, data.size());
             }
 
             gt.meta = meta;
@@ -269,7 +282,7 @@ class TextureManager {
                 params.magFilter,
                 params.wrapS,
                 params.wrapT);
-            GL_CHECK_FAILABLE(glBindTexture(GL_TEXTURE_2D, gt.id));
+            GL_CHECK_FAILABLE(_gl.bindTexture2D(0, gt.id));
             GL_CHECK_FAILABLE(
                 glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, params.minFilter));
             GL_CHECK_FAILABLE(
@@ -298,9 +311,8 @@ class TextureManager {
         auto r = ensureUploaded2D(tex, params, id);
         if (r.isError())
             return r;
-        GL_CHECK_FAILABLE(glUseProgram(program));
-        GL_CHECK_FAILABLE(glActiveTexture(GL_TEXTURE0 + unit));
-        GL_CHECK_FAILABLE(glBindTexture(GL_TEXTURE_2D, id));
+        _gl.useProgram(program);
+        _gl.bindTexture2D(unit, id);
         GL_CHECK_FAILABLE(glUniform1i((GLint)samplerLoc, (GLint)unit));
         return Failable::ok({});
     }
@@ -331,13 +343,16 @@ class TextureManager {
                a.wrapT == b.wrapT;
     }
 
+    GLStateCache& _gl;
     std::unordered_map<TextureKey, GPUTextureInfo, TextureKeyHash> _textures;
 };
 
 class GPUState {
    public:
-    UniformBlockManager blocks;
-    TextureManager textures;
+    GLStateCache gl;
+    UniformBlockManager blocks{gl};
+    TextureManager textures{gl};
+    ProgramBinaryCache programs;
 
     static GPUState& instance() {
         static GPUState s_instance;
@@ -0,0 +1,86 @@
+#include "instance_buffer.hpp"
+
+#include <okay/core/renderer/gpu.hpp>
+
+#include <algorithm>
+
+using namespace okay;
+
+namespace {
+
+constexpr std::size_t INSTANCE_BYTES = sizeof(InstanceData);
+constexpr std::size_t BLOCK_BYTES = InstanceBuffer::MAX_INSTANCES * INSTANCE_BYTES;
+constexpr std::size_t MIN_CAPACITY = 4 * BLOCK_BYTES;
+
+}  // namespace
+
+InstanceBuffer::~InstanceBuffer() {
+    if (_buffer)
+        glDeleteBuffers(1, &_buffer);
+}
+
+void InstanceBuffer::begin() {
+    if (_alignment == 0) {
+        GLint alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        _alignment = static_cast<std::size_t>(std::max<GLint>(alignment, 1));
+    }
+
+    if (_buffer) {
+        glBindBuffer(GL_UNIFORM_BUFFER, _buffer);
+        glBufferData(
+            GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(_capacity), nullptr, GL_STREAM_DRAW);
+    }
+    _cursor = 0;
+    _base = 0;
+    _staging.clear();
+}
+
+std::size_t InstanceBuffer::stage(std::span<const InstanceData> instances) {
+    // instances are 128 bytes, so only alignments above that need padding
+    std::size_t step = std::max<std::size_t>(_alignment / INSTANCE_BYTES, 1);
+    std::size_t offset = (_staging.size() + step - 1) / step * step;
+    _staging.resize(offset);
+    _staging.insert(_staging.end(), instances.begin(), instances.end());
+    return offset;
+}
+
+Failable InstanceBuffer::upload() {
+    if (_staging.empty())
+        return Failable::ok({});
+
+    std::size_t bytes = _staging.size() * INSTANCE_BYTES;
+    std::size_t start = (_cursor + _alignment - 1) / _alignment * _alignment;
+
+    // a bound range always spans a whole block, so there is a block of room past the data
+    if (_buffer == 0 || start + bytes + BLOCK_BYTES > _capacity) {
+        if (_buffer == 0)
+            GL_CHECK_FAILABLE(glGenBuffers(1, &_buffer));
+        _capacity = std::max({_capacity * 2, bytes + BLOCK_BYTES, MIN_CAPACITY});
+        GL_CHECK_FAILABLE(glBindBuffer(GL_UNIFORM_BUFFER, _buffer));
+        // draws already issued keep the storage they were issued with
+        GL_CHECK_FAILABLE(glBufferData(
+            GL_UNIFORM_BUFFER, static_cast<GLsizeiptr>(_capacity), nullptr, GL_STREAM_DRAW));
+        start = 0;
+    }
+
+    GL_CHECK_FAILABLE(glBindBuffer(GL_UNIFORM_BUFFER, _buffer));
+    GL_CHECK_FAILABLE(glBufferSubData(GL_UNIFORM_BUFFER,
+        static_cast<GLintptr>(start),
+        static_cast<GLsizeiptr>(bytes),
+        _staging.data()));
+    Engine.stats.add(Stat::BYTES_UPLOADED, bytes);
+
+    _base = start;
+    _cursor = start + bytes;
+    _staging.clear();
+    return Failable::ok({});
+}
+
+void InstanceBuffer::bind(std::size_t offset) {
+    // the range covers the whole block whatever the instance count, drivers may check the size
+    GPUState::instance().gl.bindUniformBufferRange(UniformBindings::INSTANCES,
+        _buffer,
+        static_cast<GLintptr>(_base + offset * INSTANCE_BYTES),
+        static_cast<GLsizeiptr>(BLOCK_BYTES));
+}
@@ -0,0 +1,88 @@
+#ifndef __INSTANCE_BUFFER_H__
+#define __INSTANCE_BUFFER_H__
+
+#include <okay/core/renderer/gl.hpp>
+#include <okay/core/util/result.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <span>
+#include <vector>
+
+namespace okay {
+
+// what a shader knows about the object it draws, laid out like the std140 InstanceData struct in
+// the built-in shaders
+struct alignas(16) InstanceData {
+    glm::mat4 model{1.0f};
+    // a std140 mat3 is three columns padded to vec4
+    glm::vec4 normalMatrix[3]{{1.0f, 0.0f, 0.0f, 0.0f},
+        {0.0f, 1.0f, 0.0f, 0.0f},
+        {0.0f, 0.0f, 1.0f, 0.0f}};
+    glm::vec4 tint{1.0f};
+
+    static InstanceData from(const glm::mat4& model, const glm::vec4& tint) {
+        InstanceData data;
+        data.model = model;
+        // the inverse transpose up to scale, which normalizing in the shader drops, only the sign
+        // of the determinant has to be kept so mirrored normals still point out
+        glm::vec3 x(model[0]);
+        glm::vec3 y(model[1]);
+        glm::vec3 z(model[2]);
+        float sign = glm::dot(x, glm::cross(y, z)) < 0.0f ? -1.0f : 1.0f;
+        data.normalMatrix[0] = glm::vec4(glm::cross(y, z) * sign, 0.0f);
+        data.normalMatrix[1] = glm::vec4(glm::cross(z, x) * sign, 0.0f);
+        data.normalMatrix[2] = glm::vec4(glm::cross(x, y) * sign, 0.0f);
+        data.tint = tint;
+        return data;
+    }
+};
+
+static_assert(sizeof(InstanceData) == 128, "InstanceData must match the std140 layout");
+
+// Streams per object data into a uniform buffer that instanced shaders index with gl_InstanceID, so
+// a draw only costs a glBindBufferRange. Per instance attributes (glVertexAttribDivisor, core in
+// the GL 3.3 and GLES 3.0 contexts) would need four more attributes on the shared mesh VAO, and
+// without base instance draws every run would re-point all four at its offset. Instances are staged
+// on the CPU and uploaded with one call, each staged run starts on an offset glBindBufferRange
+// accepts. The storage is orphaned every frame, which makes it a ring the driver rotates, so
+// uploads never wait on draws still reading the last one. A ring of our own fenced with glFenceSync
+// would skip the driver's reallocation but means mapping unsynchronized and tracking a fence per
+// segment, one upload a frame doesn't pay for that.
+class InstanceBuffer {
+   public:
+    // the u_instances block holds this many, 16kb is the smallest block size GLES 3 allows
+    static constexpr std::uint32_t MAX_INSTANCES = 128;
+    static constexpr const char* BLOCK_NAME = "u_instances";
+
+    InstanceBuffer() = default;
+    ~InstanceBuffer();
+
+    InstanceBuffer(const InstanceBuffer&) = delete;
+    InstanceBuffer& operator=(const InstanceBuffer&) = delete;
+
+    // starts a frame, everything uploaded for the last one is dropped
+    void begin();
+
+    // copies instances into the staging area, returns where they start for bind()
+    std::size_t stage(std::span<const InstanceData> instances);
+    // moves everything staged since the last upload to the GPU
+    Failable upload();
+    // points the instances block at the instances starting at a staged offset
+    void bind(std::size_t offset);
+
+   private:
+    GLuint _buffer{0};
+    std::size_t _capacity{0};
+    // where the next upload goes in the buffer
+    std::size_t _cursor{0};
+    // where the last upload went, staged offsets are relative to it
+    std::size_t _base{0};
+    std::size_t _alignment{0};
+    std::vector<InstanceData> _staging;
+};
+
+}  // namespace okay
+
+#endif  // __INSTANCE_BUFFER_H__
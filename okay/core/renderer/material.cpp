@@ -1,5 +1,8 @@
 #include "material.hpp"
 
+#include <okay/core/renderer/frame_uniforms.hpp>
+#include <okay/core/renderer/instance_buffer.hpp>
+
 namespace okay {
 
 Failable Shader::compile() {
@@ -8,6 +11,38 @@ Failable Shader::compile() {
         return Failable::ok({});
     }
 
+    // a binary cached by an earlier launch skips compiling and linking
+    ProgramBinaryCache& cache = GPUState::instance().programs;
+    std::uint64_t sourceKey = ProgramBinaryCache::sourceKey(vertexShader, fragmentShader);
+    _shaderProgram = cache.load(sourceKey);
+    if (_shaderProgram == 0) {
+        if (Failable built = buildFromSource(); built.isError()) {
+            return built;
+        }
+        if (Failable stored = cache.store(sourceKey, _shaderProgram); stored.isError()) {
+            Engine.logger.warn("Failed to cache shader program : {}", stored.error());
+        }
+    }
+
+    // the engine's own blocks sit on fixed binding points, programs declaring one just point it
+    // there
+    auto bindEngineBlock = [this](const char* name, GLuint bindingPoint) {
+        GLuint index = glGetUniformBlockIndex(_shaderProgram, name);
+        if (index == GL_INVALID_INDEX)
+            return false;
+        glUniformBlockBinding(_shaderProgram, index, bindingPoint);
+        return true;
+    };
+    _instanced = bindEngineBlock(InstanceBuffer::BLOCK_NAME, UniformBindings::INSTANCES);
+    bindEngineBlock(FrameUniforms::FRAME_BLOCK_NAME, UniformBindings::FRAME);
+    _sharedView = bindEngineBlock(FrameUniforms::VIEW_BLOCK_NAME, UniformBindings::VIEW);
+
+    _state = State::STANDBY;
+
+    return Failable::ok({});
+}
+
+Failable Shader::buildFromSource() {
     // Compile vertex shader
     GLuint vertex = glCreateShader(GL_VERTEX_SHADER);
     const char* vertexSrcCStr = vertexShader.c_str();
@@ -40,6 +75,7 @@ Failable Shader::compile() {
     _shaderProgram = glCreateProgram();
     glAttachShader(_shaderProgram, vertex);
     glAttachShader(_shaderProgram, fragment);
+    GPUState::instance().programs.prepare(_shaderProgram);
     glLinkProgram(_shaderProgram);
 
     // Check for linking errors
@@ -53,8 +89,6 @@ Failable Shader::compile() {
     glDeleteShader(vertex);
     glDeleteShader(fragment);
 
-    _state = State::STANDBY;
-
     return Failable::ok({});
 }
 
@@ -62,7 +96,9 @@ Failable Shader::set() {
     if (_state != State::STANDBY) {
         return Failable::errorResult("Shader must be compiled before setting it for use.");
     }
-    glUseProgram(_shaderProgram);
+    // materials set their shader before every draw, only an actual switch costs anything
+    if (GPUState::instance().gl.useProgram(_shaderProgram))
+        Engine.stats.add(Stat::SHADER_SWITCHES);
     return Failable::ok({});
 }
 
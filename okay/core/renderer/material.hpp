@@ -13,6 +13,12 @@
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
+#include <sstream>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace okay {
 
@@ -79,11 +85,24 @@ struct MaterialFlagCollection {
     }
 };
 
+struct SceneMaterialProperties;
+
+// What the renderer needs from a material's properties beyond passing them, so it never has to
+// cast them to find out. Taken once when the material is registered
+struct MaterialPipeline {
+    // camera and model matrix uniforms for shaders without the frame blocks, null if the
+    // properties have none
+    SceneMaterialProperties* scene{nullptr};
+};
+
 class IMaterialPropertyCollection {
    public:
     virtual Failable init(ShaderHandle shader) = 0;
     virtual Failable pass(ShaderHandle shader) = 0;
     virtual MaterialFlagCollection flags() = 0;
+    virtual MaterialPipeline pipeline() {
+        return {};
+    }
 };
 
 class Material {
@@ -95,7 +114,10 @@ class Material {
     Material(ShaderHandle shader,
         std::unique_ptr<IMaterialPropertyCollection> uniforms,
         std::uint32_t id)
-        : _shader(shader), _uniforms(std::move(uniforms)), _id(id) {}
+        : _shader(shader), _uniforms(std::move(uniforms)), _id(id) {
+        if (_uniforms)
+            _pipeline = _uniforms->pipeline();
+    }
 
     bool isNone() const {
         return _id == invalidID();
@@ -113,6 +135,20 @@ class Material {
         return _shader->programID();
     }
 
+    Shader* shader() {
+        return _shader.get();
+    }
+
+    // only known once the shader is compiled
+    bool isInstanced() const {
+        return _shader->instanced();
+    }
+
+    // only known once the shader is compiled
+    bool usesSharedView() const {
+        return _shader->sharedView();
+    }
+
     Failable setShader() {
         if (_shader->isNone()) {
             return Failable::errorResult("Material has no shader.");
@@ -164,10 +200,15 @@ class Material {
         return _uniforms;
     }
 
+    const MaterialPipeline& pipeline() const {
+        return _pipeline;
+    }
+
    private:
     ShaderHandle _shader;
     std::size_t _id{invalidID()};
     std::unique_ptr<IMaterialPropertyCollection> _uniforms;
+    MaterialPipeline _pipeline;
 
     void setMaterial() {
         setShader();
@@ -269,35 +310,22 @@ template <class Derived>
 class OkayMaterialProperties : public IMaterialPropertyCollection {
    public:
     Failable init(ShaderHandle shader) override {
-        auto& d = static_cast<Derived&>(*this);
-        Failable out = Failable::ok({});
-
-        // init plain uniforms (cache locations)
-        tupleForEach(d.uniformRefs(), [&](auto& u) {
-            if (out.isError())
-                return;
-            shader->findUniformLocation(u.name());
-        });
-
-        tupleForEach(d.textureRefs(), [&](auto& t) {
-            if (out.isError())
-                return;
-            shader->findUniformLocation(t.name());
-        });
-
+        resolveSlots(*shader.get());
         _initialized = true;
-        return out;
+        return Failable::ok({});
     }
 
     Failable pass(ShaderHandle shader) override {
         auto& d = static_cast<Derived&>(*this);
+        Shader& program = *shader.get();
+        const Shader::UniformSlot* slots = resolveSlots(program);
 
         std::stringstream errorMessages;
         bool anyErrors = false;
 
-        // plain uniforms (shader caches value+location)
-        tupleForEach(d.uniformRefs(), [&](auto& u) {
-            auto r = shader->setUniform(u.name(), u.get());
+        // plain uniforms (shader caches value per slot)
+        tupleForEachIndexed(d.uniformRefs(), [&](auto& u, auto i) {
+            auto r = program.setUniform(slots[i], u.get());
             if (r.isError()) {
                 errorMessages << r.error() << '\n';
                 anyErrors = true;
@@ -308,22 +336,25 @@ class OkayMaterialProperties : public IMaterialPropertyCollection {
 
         // uniform blocks (GPU manager owns UBO objects + binding points)
         tupleForEach(d.uniformBlockRefs(), [&](auto& b) {
-            auto r = gpu.blocks.pass(shader->programID(), b);
+            auto r = gpu.blocks.pass(program.programID(), b);
             if (r.isError()) {
                 errorMessages << r.error() << '\n';
                 anyErrors = true;
             }
         });
 
+        // texture slots follow the uniform slots
+        constexpr std::size_t textureBase =
+            std::tuple_size_v<decltype(std::declval<Derived&>().uniformRefs())>;
         GLuint textureUnit = 0;
-        tupleForEach(d.textureRefs(), [&](auto& t) {
-            GLuint loc = shader->findUniformLocation(t.name());
+        tupleForEachIndexed(d.textureRefs(), [&](auto& t, auto i) {
+            GLuint loc = program.slotLocation(slots[textureBase + i]);
             if (loc == uni::inactiveLocation()) {
                 return;
             }
 
             auto r = gpu.textures.bindSampler2D(
-                shader->programID(), loc, t.get(), t.params(), textureUnit);
+                program.programID(), loc, t.get(), t.params(), textureUnit);
 
             if (r.isError()) {
                 errorMessages << r.error() << '\n';
@@ -341,8 +372,42 @@ class OkayMaterialProperties : public IMaterialPropertyCollection {
         return d.flags();
     }
 
+    // resolved at compile time, the built-in materials all derive from SceneMaterialProperties
+    MaterialPipeline pipeline() override {
+        MaterialPipeline pipeline;
+        if constexpr (std::is_base_of_v<SceneMaterialProperties, Derived>)
+            pipeline.scene = static_cast<Derived*>(this);
+        return pipeline;
+    }
+
    private:
     bool _initialized{false};
+    GLuint _slotsProgram{0};
+    const Shader::UniformSlot* _slots{nullptr};
+
+    // The slots of Derived's uniforms then textures in the program, indexed by their position in
+    // uniformRefs() and textureRefs(). Names are looked up once per (material type, program),
+    // every material of this type on the program shares the table
+    const Shader::UniformSlot* resolveSlots(Shader& shader) {
+        if (_slotsProgram == shader.programID()) {
+            return _slots;
+        }
+
+        static std::unordered_map<GLuint, std::vector<Shader::UniformSlot>> tables;
+        auto [it, inserted] = tables.try_emplace(shader.programID());
+        if (inserted) {
+            auto& d = static_cast<Derived&>(*this);
+            std::vector<Shader::UniformSlot>& table = it->second;
+            tupleForEach(d.uniformRefs(),
+                [&](auto& u) { table.push_back(shader.resolveUniformSlot(u.name())); });
+            tupleForEach(d.textureRefs(),
+                [&](auto& t) { table.push_back(shader.resolveUniformSlot(t.name())); });
+        }
+
+        _slotsProgram = shader.programID();
+        _slots = it->second.data();
+        return _slots;
+    }
 };
 };  // namespace okay
 
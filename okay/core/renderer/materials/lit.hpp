@@ -12,20 +12,8 @@
 
 namespace okay {
 
-template <std::size_t MaxLights>
-struct alignas(16) LightBlock {
-    glm::vec4 meta;
-    std::array<Light, MaxLights> lights;
-};
-
-using DefaultLightBlock = LightBlock<16>;
-
+// lights come from the u_frame block every built-in shader shares, see FrameUniforms
 struct LitMaterial : public SceneMaterialProperties, public OkayMaterialProperties<LitMaterial> {
-    BlockProperty<DefaultLightBlock, FixedString("u_lights")> lights{};
-
-    LitMaterial() {
-        lights.setBindingPoint(0);
-    }
     UniformProperty<float, FixedString("u_ambient")> ambient{0.05f};
     TextureProperty<FixedString("u_albedo")> albedo;
     UniformProperty<glm::vec3, FixedString("u_color")> color{glm::vec3(1.0f)};
@@ -78,10 +66,10 @@ struct LitMaterial : public SceneMaterialProperties, public OkayMaterialProperti
     }
 
     auto uniformBlockRefs() {
-        return std::tie(lights);
+        return std::tie();
     }
     auto uniformBlockRefs() const {
-        return std::tie(lights);
+        return std::tie();
     }
 
     auto textureRefs() {
@@ -101,10 +89,6 @@ struct LitMaterial : public SceneMaterialProperties, public OkayMaterialProperti
 static_assert(sizeof(okay::Light) == 64, "OkayLight must be 64 bytes (4 vec4s)");
 static_assert(alignof(okay::Light) == 16, "OkayLight must be 16-byte aligned");
 
-static_assert(sizeof(okay::DefaultLightBlock) == 16 + 16 * 64,
-    "DefaultLightBlock must be 1040 bytes (vec4 + 16 Lights)");
-static_assert(alignof(okay::DefaultLightBlock) == 16, "DefaultLightBlock must be 16-byte aligned");
-
 }  // namespace okay
 
 #endif  // __LIT_H__
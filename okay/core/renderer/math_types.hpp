@@ -5,6 +5,9 @@
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
 
+#include <array>
+#include <utility>
+
 namespace okay {
 
 struct Transform {
@@ -58,16 +61,53 @@ struct Bounds {
         maxBound = glm::max(maxBound, point);
     }
 
+    glm::vec3 center() const {
+        return (minBound + maxBound) * 0.5f;
+    }
+
+    glm::vec3 extents() const {
+        return (maxBound - minBound) * 0.5f;
+    }
+
+    // the box around the transformed box (Arvo), exact for rotations as well: the center moves
+    // with the matrix and each new half extent is the extents weighted by the absolute axes
     Bounds transform(const glm::mat4& matrix) const {
-        glm::vec3 min = matrix * glm::vec4(minBound, 1.0f);
-        glm::vec3 max = matrix * glm::vec4(maxBound, 1.0f);
-        return Bounds(min, max);
+        glm::vec3 c = matrix * glm::vec4(center(), 1.0f);
+        glm::vec3 e = extents();
+        glm::vec3 r = glm::abs(glm::vec3(matrix[0])) * e.x + glm::abs(glm::vec3(matrix[1])) * e.y +
+                      glm::abs(glm::vec3(matrix[2])) * e.z;
+        return Bounds(c - r, c + r);
     }
 
     Bounds transform(const Transform& t) const {
         return transform(t.toMatrix());
     }
 
+    static Bounds merge(const Bounds& a, const Bounds& b) {
+        return Bounds(glm::min(a.minBound, b.minBound), glm::max(a.maxBound, b.maxBound));
+    }
+
+    Bounds expanded(float margin) const {
+        return Bounds(minBound - glm::vec3(margin), maxBound + glm::vec3(margin));
+    }
+
+    float surfaceArea() const {
+        glm::vec3 d = maxBound - minBound;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    bool contains(const Bounds& other) const {
+        return minBound.x <= other.minBound.x && minBound.y <= other.minBound.y &&
+               minBound.z <= other.minBound.z && maxBound.x >= other.maxBound.x &&
+               maxBound.y >= other.maxBound.y && maxBound.z >= other.maxBound.z;
+    }
+
+    bool overlaps(const Bounds& other) const {
+        return minBound.x <= other.maxBound.x && minBound.y <= other.maxBound.y &&
+               minBound.z <= other.maxBound.z && maxBound.x >= other.minBound.x &&
+               maxBound.y >= other.minBound.y && maxBound.z >= other.minBound.z;
+    }
+
     class CornerIterator {
         glm::vec3 minBound;
         glm::vec3 maxBound;
@@ -151,6 +191,120 @@ struct Bounds {
     }
 };
 
+struct Sphere {
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+
+    bool overlaps(const Bounds& bounds) const {
+        glm::vec3 closest = glm::max(bounds.minBound, glm::min(center, bounds.maxBound));
+        glm::vec3 d = closest - center;
+        return glm::dot(d, d) <= radius * radius;
+    }
+};
+
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+
+    glm::vec3 at(float distance) const {
+        return origin + direction * distance;
+    }
+
+    // slab test, distance is where the ray enters the box (0 when it starts inside)
+    bool intersects(const Bounds& bounds, float maxDistance, float& distance) const {
+        float tMin = 0.0f;
+        float tMax = maxDistance;
+        for (int axis = 0; axis < 3; ++axis) {
+            float inv = 1.0f / direction[axis];
+            float t0 = (bounds.minBound[axis] - origin[axis]) * inv;
+            float t1 = (bounds.maxBound[axis] - origin[axis]) * inv;
+            if (inv < 0.0f)
+                std::swap(t0, t1);
+            tMin = t0 > tMin ? t0 : tMin;
+            tMax = t1 < tMax ? t1 : tMax;
+            if (tMax < tMin)
+                return false;
+        }
+        distance = tMin;
+        return true;
+    }
+};
+
+// the six planes of a view volume, normals point inwards so inside is dot(n, p) + d >= 0
+struct Frustum {
+    enum Plane {
+        PLANE_LEFT,
+        PLANE_RIGHT,
+        PLANE_BOTTOM,
+        PLANE_TOP,
+        PLANE_NEAR,
+        PLANE_FAR,
+        PLANE_COUNT,
+    };
+
+    std::array<glm::vec4, PLANE_COUNT> planes{};
+
+    // extracts the planes from a projection * view matrix (Gribb/Hartmann), gl clip space
+    static Frustum fromMatrix(const glm::mat4& m) {
+        glm::vec4 row0(m[0][0], m[1][0], m[2][0], m[3][0]);
+        glm::vec4 row1(m[0][1], m[1][1], m[2][1], m[3][1]);
+        glm::vec4 row2(m[0][2], m[1][2], m[2][2], m[3][2]);
+        glm::vec4 row3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+        Frustum frustum;
+        frustum.planes[PLANE_LEFT] = row3 + row0;
+        frustum.planes[PLANE_RIGHT] = row3 - row0;
+        frustum.planes[PLANE_BOTTOM] = row3 + row1;
+        frustum.planes[PLANE_TOP] = row3 - row1;
+        frustum.planes[PLANE_NEAR] = row3 + row2;
+        frustum.planes[PLANE_FAR] = row3 - row2;
+        for (glm::vec4& plane : frustum.planes) {
+            plane = plane * (1.0f / glm::length(glm::vec3(plane)));
+        }
+        return frustum;
+    }
+
+    bool contains(const glm::vec3& point) const {
+        for (const glm::vec4& plane : planes) {
+            if (glm::dot(glm::vec3(plane), point) + plane.w < 0.0f)
+                return false;
+        }
+        return true;
+    }
+
+    enum class Containment { OUTSIDE, INTERSECTS, INSIDE };
+
+    // conservative like intersects, INSIDE means every plane has the whole box on its inner side
+    Containment classify(const Bounds& bounds) const {
+        glm::vec3 c = bounds.center();
+        glm::vec3 e = bounds.extents();
+        Containment result = Containment::INSIDE;
+        for (const glm::vec4& plane : planes) {
+            glm::vec3 n(plane);
+            float s = glm::dot(n, c) + plane.w;
+            float r = glm::dot(glm::abs(n), e);
+            if (s + r < 0.0f)
+                return Containment::OUTSIDE;
+            if (s - r < 0.0f)
+                result = Containment::INTERSECTS;
+        }
+        return result;
+    }
+
+    // conservative, boxes that are partly inside or straddle a corner count as visible
+    bool intersects(const Bounds& bounds) const {
+        glm::vec3 c = bounds.center();
+        glm::vec3 e = bounds.extents();
+        for (const glm::vec4& plane : planes) {
+            glm::vec3 n(plane);
+            float r = glm::dot(glm::abs(n), e);
+            if (glm::dot(n, c) + plane.w + r < 0.0f)
+                return false;
+        }
+        return true;
+    }
+};
+
 };  // namespace okay
 
 #endif  // __MATH_TYPES_H__
\ No newline at end of file
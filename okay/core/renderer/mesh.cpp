@@ -5,10 +5,12 @@
 #include <okay/core/engine/engine.hpp>
 #include <okay/core/engine/logger.hpp>
 #include <okay/core/renderer/gl.hpp>
+#include <okay/core/renderer/gpu.hpp>
 
 using namespace okay;
 
 Mesh MeshBuffer::addMesh(const MeshData& mesh) {
+    AllocationScope allocations(MemoryTag::MESH_BUFFER);
     BlockMeta* blockPtr{};
 
     for (auto& block : _blocks) {
@@ -117,6 +119,7 @@ void MeshBuffer::removeMesh(const Mesh& mesh) {
 }
 
 Mesh MeshBuffer::reserveMesh(std::size_t numVertices, std::size_t numIndices) {
+    AllocationScope allocations(MemoryTag::MESH_BUFFER);
     BlockMeta* blockPtr{};
     for (auto& block : _blocks) {
         if (block.isFree && block.vertexCount >= numVertices && block.indexCount >= numIndices) {
@@ -201,6 +204,26 @@ Result<Mesh> MeshBuffer::updateMesh(Mesh mesh, const MeshData& newModel) {
     return Result<Mesh>::errorResult("Unable to find block for mesh! Cannot update mesh data");
 }
 
+MeshData MeshBuffer::meshData(const Mesh& mesh) const {
+    MeshData data;
+    data.vertices.reserve(mesh.vertexCount);
+    for (std::size_t i = 0; i < mesh.vertexCount; ++i) {
+        const float* ptr = &_bufferData[(mesh.vertexOffset + i) * MeshVertex::numFloats()];
+        MeshVertex& v = data.vertices.emplace_back();
+        memcpy(&v.position, ptr, 3 * sizeof(float));
+        memcpy(&v.normal, ptr + 3, 3 * sizeof(float));
+        memcpy(&v.color, ptr + 6, 3 * sizeof(float));
+        memcpy(&v.uv, ptr + 9, 2 * sizeof(float));
+    }
+
+    data.indices.reserve(mesh.indexCount);
+    for (std::size_t i = 0; i < mesh.indexCount; ++i) {
+        data.indices.push_back(
+            _indices[mesh.indexOffset + i] - static_cast<std::uint32_t>(mesh.vertexOffset));
+    }
+    return data;
+}
+
 float* MeshBuffer::getMeshDataPtr(const Mesh& mesh) {
     std::size_t floatIndex{mesh.vertexOffset * MeshVertex::numFloats()};
 
@@ -224,7 +247,7 @@ Failable MeshBuffer::initVertexAttributes() {
     GL_CHECK(glGenBuffers(1, &_ebo));
 
     // MUST have a current context here.
-    GL_CHECK(glBindVertexArray(_vao));
+    GL_CHECK(GPUState::instance().gl.bindVertexArray(_vao));
 
     // This must be the VBO that contains MeshVertex data
     GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, _vbo));
@@ -261,7 +284,7 @@ Failable MeshBuffer::initVertexAttributes() {
         MeshVertex::stride(),
         reinterpret_cast<void*>(9 * sizeof(float))));
 
-    GL_CHECK(glBindVertexArray(0));
+    GL_CHECK(GPUState::instance().gl.bindVertexArray(0));
     GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
     GLint vao = 0, vbo = 0;
@@ -293,7 +316,7 @@ Failable MeshBuffer::bindMeshData() {
         return Failable::errorResult("Mesh data not initialized");
     }
 
-    GL_CHECK(glBindVertexArray(_vao));
+    GL_CHECK(GPUState::instance().gl.bindVertexArray(_vao));
 
     GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, _vbo));
     GL_CHECK(glBufferData(
@@ -307,22 +330,50 @@ Failable MeshBuffer::bindMeshData() {
 
     GL_CHECK(glBindBuffer(GL_ARRAY_BUFFER, 0));
 
+    Engine.stats.add(Stat::BYTES_UPLOADED,
+        _bufferData.size() * sizeof(GLfloat) + _indices.size() * sizeof(GLuint));
+
     // Engine.logger.debug("Mesh data bound");
     _dataOutofDate = false;
     return Failable::ok({});
 }
 
 void MeshBuffer::drawMesh(const Mesh& mesh) {
+    drawElements(mesh.indexOffset, mesh.indexCount);
+}
+
+void MeshBuffer::drawElements(std::size_t indexOffset, std::size_t indexCount) {
     if (_dataOutofDate) {
         Engine.logger.error("Mesh data not bound");
         return;
     }
 
-    glBindVertexArray(_vao);
+    // the vao stays bound between draws, everything is drawn from this one buffer
+    GPUState::instance().gl.bindVertexArray(_vao);
 
-    void* start = reinterpret_cast<void*>(mesh.indexOffset * sizeof(GLuint));
-    GLsizei count = static_cast<GLsizei>(mesh.indexCount);
+    void* start = reinterpret_cast<void*>(indexOffset * sizeof(GLuint));
+    GLsizei count = static_cast<GLsizei>(indexCount);
 
     glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, start);
-    glBindVertexArray(0);
+
+    Engine.stats.add(Stat::DRAW_CALLS);
+}
+
+void MeshBuffer::drawElementsInstanced(
+    std::size_t indexOffset, std::size_t indexCount, std::size_t instanceCount) {
+    if (_dataOutofDate) {
+        Engine.logger.error("Mesh data not bound");
+        return;
+    }
+
+    GPUState::instance().gl.bindVertexArray(_vao);
+
+    void* start = reinterpret_cast<void*>(indexOffset * sizeof(GLuint));
+    GLsizei count = static_cast<GLsizei>(indexCount);
+
+    glDrawElementsInstanced(
+        GL_TRIANGLES, count, GL_UNSIGNED_INT, start, static_cast<GLsizei>(instanceCount));
+
+    Engine.stats.add(Stat::DRAW_CALLS);
+    Engine.stats.add(Stat::INSTANCES_DRAWN, instanceCount);
 }
@@ -66,7 +66,7 @@ struct Mesh {
         return Mesh(0, 0, 0, 0, Bounds::none());
     }
 
-    bool isEmpty() {
+    bool isEmpty() const {
         return indexCount == 0;
     }
 
@@ -75,6 +75,7 @@ struct Mesh {
         vertexCount = other.vertexCount;
         indexOffset = other.indexOffset;
         indexCount = other.indexCount;
+        bounds = other.bounds;
         return *this;
     }
 
@@ -124,8 +125,13 @@ class MeshBuffer {
     Mesh reserveMesh(std::size_t numVertices, std::size_t numIndices);
 
     Result<Mesh> updateMesh(Mesh mesh, const MeshData& newModel);
+    // copies a mesh back out, indices relative to its first vertex like addMesh takes them
+    MeshData meshData(const Mesh& mesh) const;
     Failable bindMeshData();
     void drawMesh(const Mesh& mesh);
+    void drawElements(std::size_t indexOffset, std::size_t indexCount);
+    void drawElementsInstanced(
+        std::size_t indexOffset, std::size_t indexCount, std::size_t instanceCount);
 
     class Iterator {
        public:
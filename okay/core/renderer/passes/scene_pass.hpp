@@ -7,9 +7,9 @@
 #include "okay/core/renderer/render_world.hpp"
 
 #include <okay/core/engine/engine.hpp>
+#include <okay/core/renderer/command_buffer.hpp>
+#include <okay/core/renderer/command_executor.hpp>
 #include <okay/core/renderer/gl.hpp>
-#include <okay/core/renderer/materials/lit.hpp>
-#include <okay/core/renderer/materials/unlit.hpp>
 #include <okay/core/renderer/render_pipeline.hpp>
 #include <okay/core/renderer/renderer.hpp>
 #include <okay/core/renderer/uniform.hpp>
@@ -38,167 +38,66 @@ class ScenePass : public IRenderPass {
     virtual void resize(int newWidth, int newHeight) override {}
 
     virtual void render(const RendererContext& context) override {
-        GL_CHECK(glDepthMask(GL_TRUE));
-        GL_CHECK(glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE));
-        GL_CHECK(glEnable(GL_DEPTH_TEST));
-        GL_CHECK(glDisable(GL_BLEND));
-
-        GL_CHECK(glClearColor(0.113f, 0.008f, 0.208f, 1.0f));
-        GL_CHECK(glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT));
-
-        // doesn't need MSAA, but should if the platform can support it
-        glEnable(GL_MULTISAMPLE);
-
-        _shaderIndex = Shader::invalidID();
-        _materialIndex = Material::invalidID();
-        _screenSpaceProjectionMat = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 10.0f);
-
         float aspect = float(context.renderer.width()) / float(context.renderer.height());
-        auto view = context.world.camera().viewMatrix();
-        auto projection = context.world.camera().projectionMatrix(aspect);
-        auto camPos = context.world.camera().position();
-        auto camDir = context.world.camera().direction();
-
-        // render the skybox
+        const Camera& camera = context.world.camera();
+
+        RenderView view;
+        view.projection = camera.projectionMatrix(aspect);
+        view.view = camera.viewMatrix();
+        view.screenSpaceProjection = glm::ortho(-1.0f, 1.0f, -1.0f, 1.0f, 0.0f, 10.0f);
+        view.cameraPosition = camera.position();
+        view.cameraDirection = camera.direction();
+        view.timeMs = static_cast<float>(Engine.time->timeSinceStartMs());
+        view.lights = context.world.lights();
+
+        // culling and sorting run on the job system, what comes back is ready to submit
+        Frustum frustum = camera.frustum(aspect);
+        std::size_t culled = context.world.buildDrawList(frustum, _drawList);
+        Engine.stats.add(Stat::CULLED_ITEMS, culled);
+        Engine.stats.add(Stat::VISIBLE_ITEMS, _drawList.size());
+
+        // the first buffer clears and draws the skybox, the draw list is recorded in chunks
+        // that keep its order when executed one after the other
+        std::size_t chunkCount = (_drawList.size() + RECORD_CHUNK - 1) / RECORD_CHUNK;
+        if (_commandBuffers.size() < chunkCount + 1)
+            _commandBuffers.resize(chunkCount + 1);
+
+        RenderCommandBuffer& frame = _commandBuffers.front();
+        frame.reset();
+        frame.clear(glm::vec4(0.113f, 0.008f, 0.208f, 1.0f));
         MaterialHandle skyboxMaterial = context.renderer.skyboxMaterial();
-        if (skyboxMaterial.isValid()) {
-            handleMaterialSwitch(context,
-                skyboxMaterial,
-                projection,
-                view,
-                context.world.camera().position(),
-                context.world.camera().direction());
-
-            if (auto* props =
-                    dynamic_cast<SceneMaterialProperties*>(skyboxMaterial->properties().get())) {
-                props->modelMatrix = glm::identity<glm::mat4>();
-            }
-
-            Failable f = skyboxMaterial->passUniforms();
-
-            if (f.isError()) {
-                Engine.logger.error("Failed to pass skybox uniforms! Error: {}", f.error());
-            } else {
-                context.renderer.meshBuffer().drawMesh(_skyboxMesh);
-            }
-        }
-
-        for (const RenderItemHandle& handle : context.world.getRenderItems()) {
-            RenderItem& item = context.world.getRenderItem(handle);
-            if (item.mesh.isEmpty())
-                continue;
-            if (item.material->isNone())
-                continue;
-
-            Camera& camera = context.world.camera();
-            bool isScreenSpace =
-                item.material->properties()->flags().hasFlag(MaterialFlags::SCREEN_SPACE);
-            if (!isScreenSpace &&
-                !camera.isInFrustum(item.mesh.bounds.transform(item.worldMatrix), aspect)) {
-                continue;
-            }
-
-            // Shader switch: bind program + per-frame stuff
-            if (_materialIndex != item.material->id()) {
-                handleMaterialSwitch(context, item.material, projection, view, camPos, camDir);
-                _materialIndex = item.material->id();
+        if (skyboxMaterial.isValid())
+            frame.draw(0, skyboxMaterial, _skyboxMesh, glm::identity<glm::mat4>());
+
+        std::span<const RenderDrawData> drawData = context.world.drawData();
+        std::span<const glm::mat4> worldMatrices = context.world.worldMatrices();
+        auto record = [&](std::size_t begin, std::size_t end) {
+            RenderCommandBuffer& buffer = _commandBuffers[1 + begin / RECORD_CHUNK];
+            buffer.reset();
+            for (std::size_t i = begin; i < end; ++i) {
+                const RenderSortEntry& entry = _drawList[i];
+                const RenderDrawData& item = drawData[entry.index];
+                buffer.draw(
+                    entry.key, item.material, item.mesh, worldMatrices[entry.index], item.tint);
             }
-
-            // Set per-object uniforms
-            setPerObjectUniforms(item);
-
-            // Now push uniforms for this draw (or only the ones you changed)
-            Failable f = item.material->passUniforms();
-            if (f.isError())
-                Engine.logger.error("Failed to pass uniforms : {}", f.error());
-
-            applyMaterialFlags(item.material);
-            context.renderer.meshBuffer().drawMesh(item.mesh);
-        }
-    }
-
-    void handleMaterialSwitch(const RendererContext& context,
-        MaterialHandle material,
-        const glm::mat4& projection,
-        const glm::mat4& view,
-        const glm::vec3& camPos,
-        const glm::vec3& camDir) {
-        applyMaterialFlags(material);
-
-        if (_shaderIndex != material->shaderID()) {
-            if (auto f = material->setShader(); f.isError()) {
-                Engine.logger.error("Failed to set shader : {}", f.error());
-                return;
-            }
-            _shaderIndex = material->shaderID();
-        }
-
-        auto& properties = material->properties();
-        MaterialFlagCollection flags = properties->flags();
-
-        if (auto* sceneProps = dynamic_cast<okay::SceneMaterialProperties*>(properties.get())) {
-            if (flags.hasFlag(MaterialFlags::SCREEN_SPACE)) {
-                sceneProps->projectionMatrix.set(_screenSpaceProjectionMat);
-                sceneProps->viewMatrix.set(glm::identity<glm::mat4>());
-            } else {
-                sceneProps->projectionMatrix.set(projection);
-                sceneProps->viewMatrix.set(view);
-            }
-            sceneProps->cameraPosition.set(camPos);
-            sceneProps->cameraDirection.set(camDir);
-            sceneProps->timeMs.set(static_cast<float>(Engine.time->timeSinceStartMs()));
-        }
-
-        if (auto* lit = dynamic_cast<okay::LitMaterial*>(properties.get())) {
-            // per-frame lighting setup
-            DefaultLightBlock& block = lit->lights.edit();
-            block.meta.x = static_cast<float>(context.world.lights().size());
-            std::size_t i = 0;
-            for (auto l : context.world.lights()) {
-                block.lights[i++] = l;
-            }
-        }
-    }
-
-    void setPerObjectUniforms(RenderItem& item) {
-        auto& uniforms = item.material->properties();
-        if (auto* unlit = dynamic_cast<okay::SceneMaterialProperties*>(uniforms.get())) {
-            unlit->modelMatrix.set(item.worldMatrix);
-        }
-    }
-
-    void applyMaterialFlags(MaterialHandle mat) {
-        auto& uniforms = mat->properties();
-        MaterialFlagCollection flags = uniforms->flags();
-
-        if (flags.hasFlag(MaterialFlags::DOUBLE_SIDED)) {
-            GL_CHECK(glDisable(GL_CULL_FACE));
-        } else {
-            GL_CHECK(glEnable(GL_CULL_FACE));
-            GL_CHECK(glCullFace(GL_BACK));
-        }
-
-        if (flags.hasFlag(MaterialFlags::TRANSPARENT)) {
-            glEnable(GL_BLEND);
-            glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-            glDepthMask(GL_FALSE);
-        } else {
-            glDisable(GL_BLEND);
-            glDepthMask(GL_TRUE);
-        }
-
-        if (flags.hasFlag(MaterialFlags::SCREEN_SPACE)) {
-            glDisable(GL_DEPTH_TEST);
-        } else {
-            glEnable(GL_DEPTH_TEST);
+        };
+        Engine.jobs.parallelFor(_drawList.size(), RECORD_CHUNK, record);
+
+        _executor.begin(view);
+        for (std::size_t i = 0; i < chunkCount + 1; ++i) {
+            _executor.execute(_commandBuffers[i],
+                context.renderer.meshBuffer(),
+                context.renderer.materialRegistry());
         }
     }
 
    private:
-    std::uint32_t _shaderIndex{Shader::invalidID()};
-    std::uint32_t _materialIndex{Material::invalidID()};
-    glm::mat4 _screenSpaceProjectionMat{};
+    static constexpr std::size_t RECORD_CHUNK = 1024;
+
     Mesh _skyboxMesh;
+    std::vector<RenderSortEntry> _drawList;
+    std::vector<RenderCommandBuffer> _commandBuffers;
+    GLCommandExecutor _executor;
 };
 
 };  // namespace okay
@@ -0,0 +1,220 @@
+#include "program_cache.hpp"
+
+#include <okay/core/engine/engine.hpp>
+#include <okay/core/renderer/surface.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+using namespace okay;
+
+namespace {
+
+// GL 4.1 / GLES 3.0 enums, the vendored GL 3.1 header doesn't have them
+constexpr GLenum PROGRAM_BINARY_RETRIEVABLE_HINT = 0x8257;
+constexpr GLenum PROGRAM_BINARY_LENGTH = 0x8741;
+constexpr GLenum NUM_PROGRAM_BINARY_FORMATS = 0x87FE;
+
+// stable across builds and platforms, unlike std::hash
+constexpr std::uint64_t FNV_OFFSET = 14695981039346656037ull;
+
+std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash = FNV_OFFSET) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i)
+        hash = (hash ^ bytes[i]) * 1099511628211ull;
+    return hash;
+}
+
+std::uint64_t fnv1a(std::string_view text, std::uint64_t hash = FNV_OFFSET) {
+    // the terminator keeps "ab" + "c" and "a" + "bc" apart
+    return fnv1a(text.data(), text.size() + 1, hash);
+}
+
+std::string_view glString(GLenum name) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    return value ? std::string_view(value) : std::string_view();
+}
+
+struct EntryHeader {
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint64_t driverHash;
+    std::uint64_t sourceKey;
+    std::uint64_t binaryHash;
+    std::uint32_t binaryFormat;
+    std::uint32_t binaryLength;
+};
+
+}  // namespace
+
+std::uint64_t ProgramBinaryCache::sourceKey(
+    const std::string& vertexSource, const std::string& fragmentSource) {
+    return fnv1a(fragmentSource, fnv1a(vertexSource));
+}
+
+bool ProgramBinaryCache::enabled() {
+    if (_probed)
+        return _enabled;
+    _probed = true;
+
+    _directory = DEFAULT_DIRECTORY;
+    if (const char* directory = std::getenv("OKAY_SHADER_CACHE"))
+        _directory = directory;
+    if (_directory.empty())
+        return false;
+
+    _getProgramBinary =
+        reinterpret_cast<GetProgramBinaryProc>(Surface::getProcAddress("glGetProgramBinary"));
+    _programBinary =
+        reinterpret_cast<ProgramBinaryProc>(Surface::getProcAddress("glProgramBinary"));
+    _programParameteri =
+        reinterpret_cast<ProgramParameteriProc>(Surface::getProcAddress("glProgramParameteri"));
+    if (!_getProgramBinary || !_programBinary) {
+        Engine.logger.info("Program binaries aren't supported, shaders are built from source");
+        return false;
+    }
+
+    // some lookups hand out stubs for anything, a driver without binaries has no formats and
+    // fails this query with GL_INVALID_ENUM
+    GLint formats = 0;
+    glGetIntegerv(NUM_PROGRAM_BINARY_FORMATS, &formats);
+    glClearErrors();
+    if (formats <= 0) {
+        Engine.logger.info("No program binary formats, shaders are built from source");
+        return false;
+    }
+
+    // a driver update may change what it accepts, its binaries are only trusted by the same one
+    std::uint64_t hash = fnv1a(glString(GL_VENDOR));
+    hash = fnv1a(glString(GL_RENDERER), hash);
+    hash = fnv1a(glString(GL_VERSION), hash);
+    hash = fnv1a(glString(GL_SHADING_LANGUAGE_VERSION), hash);
+    _driverHash = hash;
+
+    std::error_code ec;
+    std::filesystem::create_directories(_directory, ec);
+    if (ec) {
+        Engine.logger.warn("Failed to create shader cache directory {} : {}",
+            _directory.string(),
+            ec.message());
+        return false;
+    }
+
+    _enabled = true;
+    return true;
+}
+
+std::filesystem::path ProgramBinaryCache::entryPath(std::uint64_t sourceKey) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(sourceKey));
+    return _directory / name;
+}
+
+GLuint ProgramBinaryCache::load(std::uint64_t sourceKey) {
+    if (!enabled())
+        return 0;
+
+    std::filesystem::path path = entryPath(sourceKey);
+    std::ifstream in(path, std::ios::in | std::ios::binary | std::ios::ate);
+    if (!in.is_open())
+        return 0;
+
+    std::size_t fileSize = static_cast<std::size_t>(in.tellg());
+    in.seekg(0);
+    std::vector<char> data(fileSize);
+    in.read(data.data(), static_cast<std::streamsize>(fileSize));
+    in.close();
+
+    // anything unexpected is treated like a miss, the entry is rewritten after building
+    EntryHeader header{};
+    if (fileSize >= sizeof(header))
+        std::memcpy(&header, data.data(), sizeof(header));
+    const char* binary = data.data() + sizeof(header);
+    bool valid = fileSize >= sizeof(header) && header.magic == MAGIC &&
+                 header.version == VERSION && header.driverHash == _driverHash &&
+                 header.sourceKey == sourceKey &&
+                 header.binaryLength == fileSize - sizeof(header) &&
+                 header.binaryHash == fnv1a(binary, header.binaryLength);
+    if (!valid) {
+        Engine.logger.info("Stale shader cache entry {}, building from source", path.string());
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glClearErrors();
+    _programBinary(program,
+        static_cast<GLenum>(header.binaryFormat),
+        binary,
+        static_cast<GLsizei>(header.binaryLength));
+
+    GLint linked = GL_FALSE;
+    if (glGetError() == GL_NO_ERROR)
+        glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        Engine.logger.warn("Driver rejected cached program {}, building from source",
+            path.string());
+        glDeleteProgram(program);
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+        return 0;
+    }
+
+    return program;
+}
+
+void ProgramBinaryCache::prepare(GLuint program) {
+    if (enabled() && _programParameteri)
+        _programParameteri(program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+Failable ProgramBinaryCache::store(std::uint64_t sourceKey, GLuint program) {
+    if (!enabled())
+        return Failable::ok({});
+
+    GLint length = 0;
+    glGetProgramiv(program, PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return Failable::errorResult("Driver returned no binary for program " +
+                                     std::to_string(program));
+
+    EntryHeader header{};
+    std::vector<char> data(sizeof(header) + static_cast<std::size_t>(length));
+    GLsizei written = 0;
+    GLenum format = 0;
+    GL_CHECK_FAILABLE(
+        _getProgramBinary(program, length, &written, &format, data.data() + sizeof(header)));
+
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.driverHash = _driverHash;
+    header.sourceKey = sourceKey;
+    header.binaryHash = fnv1a(data.data() + sizeof(header), static_cast<std::size_t>(written));
+    header.binaryFormat = static_cast<std::uint32_t>(format);
+    header.binaryLength = static_cast<std::uint32_t>(written);
+    std::memcpy(data.data(), &header, sizeof(header));
+
+    // written aside and renamed over the entry, power loss mid write leaves the old entry or none
+    std::filesystem::path path = entryPath(sourceKey);
+    std::filesystem::path temp = path;
+    temp += ".tmp";
+    {
+        std::ofstream out(temp, std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return Failable::errorResult("Failed to open shader cache entry " + temp.string());
+        out.write(data.data(), static_cast<std::streamsize>(sizeof(header) + written));
+        if (!out)
+            return Failable::errorResult("Failed to write shader cache entry " + temp.string());
+    }
+
+    std::error_code ec;
+    std::filesystem::rename(temp, path, ec);
+    if (ec)
+        return Failable::errorResult("Failed to move shader cache entry into place: " +
+                                     ec.message());
+    return Failable::ok({});
+}
@@ -0,0 +1,61 @@
+#ifndef __PROGRAM_CACHE_H__
+#define __PROGRAM_CACHE_H__
+
+#include <okay/core/renderer/gl.hpp>
+#include <okay/core/util/result.hpp>
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+namespace okay {
+
+// Linked program binaries kept on disk, so later launches skip compiling and linking GLSL. An
+// entry is keyed by the program's final source and the driver that produced it, anything that
+// doesn't match or that the driver rejects is dropped and the program is built from source again.
+// The vendored loader is GL 3.1, so the binary entry points (GL 4.1, ARB_get_program_binary and
+// GLES 3.0) are looked up through the surface. Without them or any binary format the cache does
+// nothing.
+class ProgramBinaryCache {
+   public:
+    // next to the logs, OKAY_SHADER_CACHE overrides it and an empty value turns the cache off
+    static constexpr const char* DEFAULT_DIRECTORY = "shader_cache";
+
+    static std::uint64_t sourceKey(
+        const std::string& vertexSource, const std::string& fragmentSource);
+
+    // a linked program made from the cached binary, 0 if there is none or it didn't link
+    GLuint load(std::uint64_t sourceKey);
+
+    // call before linking a program that will be stored, some drivers only keep a retrievable
+    // binary when asked to
+    void prepare(GLuint program);
+    Failable store(std::uint64_t sourceKey, GLuint program);
+
+   private:
+    static constexpr std::uint32_t MAGIC = 0x4F4B5042;  // "OKPB"
+    static constexpr std::uint32_t VERSION = 1;
+
+    typedef void(APIENTRYP GetProgramBinaryProc)(
+        GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    typedef void(APIENTRYP ProgramBinaryProc)(
+        GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+    typedef void(APIENTRYP ProgramParameteriProc)(GLuint program, GLenum pname, GLint value);
+
+    GetProgramBinaryProc _getProgramBinary{nullptr};
+    ProgramBinaryProc _programBinary{nullptr};
+    ProgramParameteriProc _programParameteri{nullptr};
+
+    bool _probed{false};
+    bool _enabled{false};
+    std::uint64_t _driverHash{0};
+    std::filesystem::path _directory;
+
+    // checks for support and hashes the driver strings, needs a current context
+    bool enabled();
+    std::filesystem::path entryPath(std::uint64_t sourceKey) const;
+};
+
+}  // namespace okay
+
+#endif  // __PROGRAM_CACHE_H__
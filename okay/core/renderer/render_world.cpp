@@ -3,7 +3,11 @@
 #include "glm/ext/matrix_transform.hpp"
 #include "material.hpp"
 
-#include <queue>
+#include <okay/core/engine/engine.hpp>
+#include <okay/core/util/frame_arena.hpp>
+#include <okay/core/util/radix_sort.hpp>
+
+#include <algorithm>
 
 using namespace okay;
 
@@ -12,8 +16,7 @@ using namespace okay;
 RenderWorld::ChildIterator& RenderWorld::ChildIterator::operator++() {
     if (_renderItem == RenderItemHandle::invalidHandle())
         return *this;
-    const RenderItem& item = world._renderItemPool.get(_renderItem);
-    _renderItem = item.nextSibling;
+    _renderItem = world._hierarchy[world.renderIndex(_renderItem)].nextSibling;
     return *this;
 }
 
@@ -42,11 +45,14 @@ RenderEntity::Properties::~Properties() {
 
 RenderEntity::Properties RenderEntity::operator*() const {
     Properties p(_owner, _renderItem);
-    const RenderItem& item = _owner->getRenderItem(_renderItem);
-    p.material = item.material;
-    p.mesh = item.mesh;
-    p.transform = item.transform;
-    p.renderLayer = item.renderLayer;
+    RenderIndex index = _owner->renderIndex(_renderItem);
+    const RenderDrawData& drawData = _owner->_drawData[index];
+    p.material = drawData.material;
+    p.mesh = drawData.mesh;
+    p.transform = _owner->_localTransforms[index];
+    p.renderLayer = drawData.renderLayer;
+    p.tint = drawData.tint;
+    p.isStatic = drawData.isStatic;
     return p;
 }
 
@@ -71,7 +77,7 @@ RenderWorld::ChildRange RenderWorld::children(RenderEntity parent) {
         return ChildRange(ChildIterator(*this, RenderItemHandle::invalidHandle()),
             ChildIterator(*this, RenderItemHandle::invalidHandle()));
     }
-    const RenderItem& p = _renderItemPool.get(parent._renderItem);
+    const RenderHierarchy& p = _hierarchy[renderIndex(parent._renderItem)];
     return ChildRange(ChildIterator(*this, p.firstChild),
         ChildIterator(*this, RenderItemHandle::invalidHandle()));
 }
@@ -80,136 +86,412 @@ const RenderWorld::ChildRange RenderWorld::children(RenderEntity parent) const {
     return const_cast<RenderWorld*>(this)->children(parent);
 }
 
-void RenderWorld::rebuildTransforms() {
-    if (_dirtyTransforms.empty())
+void RenderWorld::appendTransformSlot(RenderIndex index, std::uint32_t parentSlot) {
+    std::uint32_t slot = static_cast<std::uint32_t>(_transformOrder.size());
+    _transformOrder.push_back(index);
+    _transformParents.push_back(parentSlot);
+    _subtreeEnds.push_back(slot + 1);
+    _dirtyTransforms.resize(_transformOrder.size());
+    _transformSlots[index] = slot;
+}
+
+void RenderWorld::rebuildTransformOrder() {
+    _transformOrder.clear();
+    _transformParents.clear();
+    _subtreeEnds.clear();
+    std::fill(_transformSlots.begin(), _transformSlots.end(), NO_INDEX);
+    _removedTransformSlots = 0;
+    // slots are appended again below, dirty bits of the old order must not outlive it
+    _dirtyTransforms.clear();
+    _dirtyTransforms.resize(0);
+    _needsTransformOrderRebuild = false;
+
+    if (_handles.empty())
         return;
 
-    std::queue<RenderItemHandle> q;
-    std::set<RenderItemHandle> dirtyRoots;
-    // Find highest dirty ancestor for each dirty node, de-dup
-    for (RenderItemHandle h : _dirtyTransforms) {
-        RenderItemHandle r = h;
-        while (true) {
-            RenderItemHandle p = _renderItemPool.get(r).parent;
-            if (p == RenderItemHandle::invalidHandle())
-                break;
-            if (_dirtyTransforms.find(p) == _dirtyTransforms.end())
-                break;
-            r = p;
+    // depth first from every root, a popped item's parent always has its slot already
+    FrameVector<RenderIndex> stack(&FrameArena::local());
+    for (RenderIndex root = 0; root < _handles.size(); ++root) {
+        if (_hierarchy[root].parent != RenderItemHandle::invalidHandle())
+            continue;
+
+        stack.push_back(root);
+        while (!stack.empty()) {
+            RenderIndex index = stack.back();
+            stack.pop_back();
+
+            const RenderHierarchy& hierarchy = _hierarchy[index];
+            appendTransformSlot(index,
+                hierarchy.parent == RenderItemHandle::invalidHandle()
+                    ? NO_INDEX
+                    : _transformSlots[renderIndex(hierarchy.parent)]);
+
+            for (RenderItemHandle c = hierarchy.firstChild; c != RenderItemHandle::invalidHandle();
+                c = _hierarchy[renderIndex(c)].nextSibling) {
+                stack.push_back(renderIndex(c));
+            }
         }
-        dirtyRoots.insert(r);
     }
 
-    // Seed queue with dirty roots, recompute their world from parent
-    for (RenderItemHandle r : dirtyRoots) {
-        RenderItem& item = _renderItemPool.get(r);
-        glm::mat4 parentWorld = (item.parent == RenderItemHandle::invalidHandle())
-                                    ? glm::identity<glm::mat4>()
-                                    : _renderItemPool.get(item.parent).worldMatrix;
-
-        item.worldMatrix = parentWorld * item.transform.toMatrix();
-        q.push(r);
+    // children come after their parent, so walking backwards finishes every subtree before
+    // its end is folded into the parent
+    for (std::size_t i = _transformOrder.size(); i-- > 0;) {
+        std::uint32_t parent = _transformParents[i];
+        if (parent != NO_INDEX)
+            _subtreeEnds[parent] = std::max(_subtreeEnds[parent], _subtreeEnds[i]);
     }
 
-    // BFS down each root, recompute children from parent.worldMatrix
-    while (!q.empty()) {
-        RenderItemHandle pHandle = q.front();
-        q.pop();
-
-        const RenderItem& parent = _renderItemPool.get(pHandle);
-        RenderItemHandle c = parent.firstChild;
+    _dirtyTransforms.setAll();
+}
 
-        while (c != RenderItemHandle::invalidHandle()) {
-            RenderItem& child = _renderItemPool.get(c);
-            child.worldMatrix = parent.worldMatrix * child.transform.toMatrix();
-            q.push(c);
-            c = child.nextSibling;
+void RenderWorld::rebuildTransforms() {
+    if (_needsTransformOrderRebuild)
+        rebuildTransformOrder();
+
+    // a dirty slot invalidates its whole subtree, which is the range up to its subtree end
+    std::size_t slot = _dirtyTransforms.findNext(0);
+    while (slot != DirtyBitset::npos) {
+        std::size_t end = _subtreeEnds[slot];
+        for (std::size_t i = slot; i < end; ++i) {
+            RenderIndex index = _transformOrder[i];
+            if (index == NO_INDEX)
+                continue;
+
+            glm::mat4 local = _localTransforms[index].toMatrix();
+            std::uint32_t parent = _transformParents[i];
+            _worldMatrices[index] =
+                parent == NO_INDEX ? local : _worldMatrices[_transformOrder[parent]] * local;
+            // parents of a moved item are dirty too, only boxes that changed touch the trees
+            Bounds bounds = _drawData[index].mesh.bounds.transform(_worldMatrices[index]);
+            // batches stand in for their members, which queries already find
+            if ((_worldBounds.set(index, bounds) ||
+                    _spatialProxies[index].node == AABBTree::NULL_NODE) &&
+                !_drawData[index].isStaticBatch)
+                updateSpatialProxy(index, bounds);
         }
+        slot = _dirtyTransforms.findNext(end);
     }
 
     _dirtyTransforms.clear();
 }
 
-void RenderWorld::rebuildMaterials() {
-    // recompute the sortKeys for every render item
-    for (int i = 0; i < _activeRenderItems; i++) {
-        RenderItem& item = _renderItemPool.get(_memoizedRenderItems[i]);
-        item.computeSortKey();
-    }
+void RenderWorld::rebuildDrawOrder() {
+    // recompute the sortKeys for every render item, entries start in index order and the sort
+    // is stable, so equal keys end up ordered by index
+    _drawOrder.resize(_handles.size());
+    auto computeKeys = [&](std::size_t begin, std::size_t end) {
+        for (RenderIndex index = static_cast<RenderIndex>(begin); index < end; ++index) {
+            _sortKeys[index] = _drawData[index].computeSortKey();
+            _drawFlags[index] = _drawData[index].computeDrawFlags();
+            _drawOrder[index] = RenderSortEntry{_sortKeys[index], index};
+        }
+    };
+    Engine.jobs.parallelFor(_handles.size(), SORT_KEY_CHUNK, computeKeys);
+
+    _drawOrderScratch.resize(_drawOrder.size());
+    radixSort(std::span<RenderSortEntry>(_drawOrder),
+        std::span<RenderSortEntry>(_drawOrderScratch),
+        [](const RenderSortEntry& entry) { return entry.key; });
 
-    std::sort(_memoizedRenderItems.begin(),
-        _memoizedRenderItems.begin() + _activeRenderItems,
-        [this](const RenderItemHandle& a, const RenderItemHandle& b) {
-            bool aValid = isValidEntity(a);
-            bool bValid = isValidEntity(b);
+    _staleSortEntries.clear();
+    _dirtySortKeys.clear();
+    _needsDrawOrderRebuild = false;
+}
 
-            if (aValid != bValid)
-                return aValid;
+void RenderWorld::patchDrawOrder() {
+    FrameVector<RenderSortEntry> inserted(&FrameArena::local());
+    for (RenderIndex index : _dirtySortKeys.items()) {
+        // indices past the end belonged to items that were removed since
+        if (index >= _handles.size())
+            continue;
+        _sortKeys[index] = _drawData[index].computeSortKey();
+        _drawFlags[index] = _drawData[index].computeDrawFlags();
+        inserted.push_back(RenderSortEntry{_sortKeys[index], index});
+    }
+    std::sort(inserted.begin(), inserted.end());
+    std::sort(_staleSortEntries.begin(), _staleSortEntries.end());
+
+    // stale entries show up in the same order as in the draw order, so dropping them and
+    // merging in the new ones is a single pass
+    _drawOrderScratch.clear();
+    _drawOrderScratch.reserve(_handles.size());
+    std::size_t stale = 0;
+    auto next = inserted.begin();
+    for (const RenderSortEntry& entry : _drawOrder) {
+        if (stale < _staleSortEntries.size() && _staleSortEntries[stale] == entry) {
+            ++stale;
+            continue;
+        }
+        for (; next != inserted.end() && *next < entry; ++next) {
+            _drawOrderScratch.push_back(*next);
+        }
+        _drawOrderScratch.push_back(entry);
+    }
+    _drawOrderScratch.insert(_drawOrderScratch.end(), next, inserted.end());
+    std::swap(_drawOrder, _drawOrderScratch);
 
-            if (!aValid)
-                return false;
+    _staleSortEntries.clear();
+    _dirtySortKeys.clear();
+}
 
-            return getRenderItem(a).sortKey < getRenderItem(b).sortKey;
-        });
+void RenderWorld::markSortKeyDirty(RenderIndex index) {
+    // a pending full rebuild recomputes every key anyway
+    if (_needsDrawOrderRebuild)
+        return;
 
-    _needsMaterialRebuild = false;
+    // the first change since the last patch retires the item's current entry
+    if (_dirtySortKeys.insert(index))
+        _staleSortEntries.push_back(RenderSortEntry{_sortKeys[index], index});
 }
 
 void RenderWorld::handleDirtyMesh(RenderItemHandle dirtyEntity) {
-    // meshses don't affect anything
+    // the world bounds follow the mesh and empty meshes sort last
+    handleDirtyTransform(dirtyEntity);
+    markSortKeyDirty(renderIndex(dirtyEntity));
 }
 
 void RenderWorld::handleDirtyMaterial(RenderItemHandle dirtyEntity) {
-    _needsMaterialRebuild = true;
+    markSortKeyDirty(renderIndex(dirtyEntity));
 }
 
 void RenderWorld::handleDirtyTransform(RenderItemHandle dirtyEntity) {
-    // is the entity already in the dirty set?
-    if (_dirtyTransforms.find(dirtyEntity) != _dirtyTransforms.end()) {
+    // a pending order rebuild recomputes every world matrix anyway
+    if (_needsTransformOrderRebuild)
         return;
+
+    std::uint32_t slot = _transformSlots[renderIndex(dirtyEntity)];
+    if (slot != NO_INDEX)
+        _dirtyTransforms.set(slot);
+}
+
+void RenderWorld::updateSpatialProxy(RenderIndex index, const Bounds& bounds) {
+    SpatialProxy& proxy = _spatialProxies[index];
+    if (proxy.node != AABBTree::NULL_NODE && proxy.isStatic) {
+        _staticTree.remove(proxy.node);
+        proxy.node = AABBTree::NULL_NODE;
     }
-    // Engine.logger.debug("Adding dirty transform {}", dirtyEntity.index);
-    _dirtyTransforms.insert(dirtyEntity);
+
+    if (proxy.node == AABBTree::NULL_NODE)
+        proxy.node = _dynamicTree.insert(bounds, index);
+    else
+        _dynamicTree.move(proxy.node, bounds);
+    proxy.isStatic = false;
+    proxy.lastMoved = _spatialFrame;
 }
 
-const std::span<RenderItemHandle> RenderWorld::getRenderItems() {
-    if (_needsMaterialRebuild)
-        rebuildMaterials();
-    if (!_dirtyTransforms.empty())
-        rebuildTransforms();
-    return std::span<RenderItemHandle>(_memoizedRenderItems.data(), _activeRenderItems);
+void RenderWorld::removeSpatialProxy(RenderIndex index) {
+    SpatialProxy& proxy = _spatialProxies[index];
+    if (proxy.node == AABBTree::NULL_NODE)
+        return;
+    (proxy.isStatic ? _staticTree : _dynamicTree).remove(proxy.node);
+    proxy.node = AABBTree::NULL_NODE;
+}
+
+void RenderWorld::promoteStaticItems() {
+    for (RenderIndex index = 0; index < _spatialProxies.size(); ++index) {
+        SpatialProxy& proxy = _spatialProxies[index];
+        if (proxy.node == AABBTree::NULL_NODE || proxy.isStatic ||
+            _spatialFrame - proxy.lastMoved < STATIC_AFTER_FRAMES)
+            continue;
+
+        // static leaves are tight, they only leave the tree again when the item moves
+        _dynamicTree.remove(proxy.node);
+        proxy.node = _staticTree.insert(_worldBounds.get(index), index);
+        proxy.isStatic = true;
+    }
+}
+
+template <typename Shape>
+void RenderWorld::queryTrees(const Shape& shape, std::vector<RenderIndex>& out) {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    // the dynamic leaves are fat, so their hits are checked against the tight bounds
+    rebuildTransforms();
+    _staticTree.queryOverlap(shape, [&](std::uint32_t index) { out.push_back(index); });
+    _dynamicTree.queryOverlap(shape, [&](std::uint32_t index) {
+        if (shape.overlaps(_worldBounds.get(index)))
+            out.push_back(index);
+    });
+}
+
+void RenderWorld::queryFrustum(const Frustum& frustum, std::vector<RenderIndex>& visible) {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    rebuildTransforms();
+    _staticTree.queryFrustum(frustum, [&](std::uint32_t index) { visible.push_back(index); });
+    _dynamicTree.queryFrustum(frustum, [&](std::uint32_t index) {
+        if (frustum.intersects(_worldBounds.get(index)))
+            visible.push_back(index);
+    });
+}
+
+void RenderWorld::queryOverlap(const Bounds& bounds, std::vector<RenderIndex>& overlapping) {
+    queryTrees(bounds, overlapping);
+}
+
+void RenderWorld::queryOverlap(const Sphere& sphere, std::vector<RenderIndex>& overlapping) {
+    queryTrees(sphere, overlapping);
+}
+
+Option<RenderRayHit> RenderWorld::raycast(const Ray& ray, float maxDistance) {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    rebuildTransforms();
+
+    RenderIndex closest = NO_INDEX;
+    auto hit = [&](std::uint32_t index, float) {
+        float distance = 0.0f;
+        if (!_drawData[index].mesh.isEmpty() &&
+            ray.intersects(_worldBounds.get(index), maxDistance, distance)) {
+            maxDistance = distance;
+            closest = index;
+        }
+        return maxDistance;
+    };
+    _staticTree.raycast(ray, maxDistance, hit);
+    _dynamicTree.raycast(ray, maxDistance, hit);
+
+    if (closest == NO_INDEX)
+        return Option<RenderRayHit>::none();
+    return Option<RenderRayHit>::some(
+        RenderRayHit{RenderEntity(this, _handles[closest]), maxDistance});
+}
+
+std::span<const RenderSortEntry> RenderWorld::drawOrder() {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    // past a few changed keys resorting everything is cheaper than patching
+    if (_needsDrawOrderRebuild || _dirtySortKeys.size() > _handles.size() / 8)
+        rebuildDrawOrder();
+    else if (!_dirtySortKeys.empty())
+        patchDrawOrder();
+    rebuildTransforms();
+
+    if (++_spatialFrame % STATIC_SWEEP_INTERVAL == 0)
+        promoteStaticItems();
+    return _drawOrder;
+}
+
+std::size_t RenderWorld::buildDrawList(
+    const Frustum& frustum, std::vector<RenderSortEntry>& drawList) {
+    // the draw order is kept sorted incrementally, culling only has to filter it
+    std::span<const RenderSortEntry> order = drawOrder();
+
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    std::size_t count = _handles.size();
+    std::size_t chunkCount = (count + DRAW_LIST_CHUNK - 1) / DRAW_LIST_CHUNK;
+    if (_drawListChunks.size() < chunkCount)
+        _drawListChunks.resize(chunkCount);
+    _drawnItems.assign(count, 0);
+    drawList.resize(count);
+
+    // the trees are split into subtrees a few levels down, so the walks run as separate jobs
+    // and subtrees outside the frustum are dropped before any job starts
+    _staticCullPieces.clear();
+    _dynamicCullPieces.clear();
+    _staticTree.splitFrustumQuery(frustum, CULL_SPLIT_DEPTH, _staticCullPieces);
+    _dynamicTree.splitFrustumQuery(frustum, CULL_SPLIT_DEPTH, _dynamicCullPieces);
+
+    // every item is a leaf of one tree, so the jobs mark disjoint entries
+    std::size_t staticPieces = _staticCullPieces.size();
+    Engine.jobs.parallelFor(staticPieces + _dynamicCullPieces.size(),
+        1,
+        [&](std::size_t begin, std::size_t end) {
+            for (std::size_t piece = begin; piece < end; ++piece) {
+                if (piece < staticPieces) {
+                    _staticTree.queryFrustum(frustum,
+                        _staticCullPieces[piece],
+                        [&](std::uint32_t index) { _drawnItems[index] = 1; });
+                    continue;
+                }
+                // the dynamic leaves are fat, so their hits are checked against the tight bounds
+                _dynamicTree.queryFrustum(frustum,
+                    _dynamicCullPieces[piece - staticPieces],
+                    [&](std::uint32_t index) {
+                        if (frustum.intersects(_worldBounds.get(index)))
+                            _drawnItems[index] = 1;
+                    });
+            }
+        });
+
+    // the drawn entries keep their place in the draw order, so they come out sorted
+    Engine.jobs.parallelFor(count, DRAW_LIST_CHUNK, [&](std::size_t begin, std::size_t end) {
+        RenderSortEntry* out = drawList.data() + begin;
+        std::uint32_t drawCount = 0;
+        std::uint32_t culledCount = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            RenderIndex index = order[i].index;
+            std::uint8_t flags = _drawFlags[index];
+            bool drawable = flags & RenderDrawData::DRAWABLE;
+            bool drawn =
+                drawable && (_drawnItems[index] || (flags & RenderDrawData::SCREEN_SPACE));
+            _drawnItems[index] = drawn;
+            culledCount += drawable && !drawn;
+            if (drawn)
+                out[drawCount++] = order[i];
+        }
+        DrawListChunk& chunk = _drawListChunks[begin / DRAW_LIST_CHUNK];
+        chunk.drawCount = drawCount;
+        chunk.culledCount = culledCount;
+    });
+
+    // chunk i wrote from i * DRAW_LIST_CHUNK on, which is never behind the compacted end
+    std::size_t size = 0;
+    std::size_t culled = 0;
+    for (std::size_t i = 0; i < chunkCount; ++i) {
+        const DrawListChunk& chunk = _drawListChunks[i];
+        RenderSortEntry* first = drawList.data() + i * DRAW_LIST_CHUNK;
+        std::copy(first, first + chunk.drawCount, drawList.data() + size);
+        size += chunk.drawCount;
+        culled += chunk.culledCount;
+    }
+    drawList.resize(size);
+    return culled;
 }
 
 RenderEntity RenderWorld::addRenderEntity(const Transform& transform,
     const MaterialHandle& material,
     const Mesh& mesh,
     RenderEntity parent) {
-    RenderItemHandle handle = _renderItemPool.emplace(material, mesh);
-    // add this handle to the _memozedRenderItems vector
-    _activeRenderItems++;
-    if (_activeRenderItems > _memoizedRenderItems.size()) {
-        _memoizedRenderItems.push_back(handle);
-    } else {
-        _memoizedRenderItems[_activeRenderItems - 1] = handle;
-    }
-
-    RenderItem& item = _renderItemPool.get(handle);
-
-    item.transform = transform;
-    item.material = material;
-    item.mesh = mesh;
-    item.renderLayer = 0;
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    RenderIndex index = static_cast<RenderIndex>(_handles.size());
+    RenderItemHandle handle = _renderItemPool.emplace(RenderItem{index});
+
+    _handles.push_back(handle);
+    _worldBounds.push_back(Bounds());
+    _worldMatrices.emplace_back(1.0f);
+    _sortKeys.push_back(std::numeric_limits<std::uint64_t>::max());
+    _drawFlags.push_back(0);
+    _drawData.push_back(RenderDrawData{material, mesh, 0});
+    _localTransforms.push_back(transform);
+    _hierarchy.emplace_back();
+    _transformSlots.push_back(NO_INDEX);
+    _spatialProxies.emplace_back();
+    // a new item has no entry in the draw order to retire
+    if (!_needsDrawOrderRebuild)
+        _dirtySortKeys.insert(index);
 
     RenderEntity entity(this, handle);
 
     // set up parent-child relationship
+    std::uint32_t parentSlot = NO_INDEX;
     if (parent._renderItem != RenderItemHandle::invalidHandle()) {
         Failable f = addChild(parent, entity);
         if (f.isError()) {
             // failed to add child, clean up and return invalid entity
+            swapRemove(index);
             _renderItemPool.destroy(handle);
             return RenderEntity(this, RenderItemHandle::invalidHandle());
         }
+        parentSlot = _transformSlots[renderIndex(parent._renderItem)];
+    }
+
+    // a new root, or a child of the subtree that ends the order, can be appended in place,
+    // anything else has to wait for the order to be rebuilt
+    if (!_needsTransformOrderRebuild &&
+        (parentSlot == NO_INDEX || _subtreeEnds[parentSlot] == _transformOrder.size())) {
+        appendTransformSlot(index, parentSlot);
+        for (std::uint32_t p = parentSlot; p != NO_INDEX; p = _transformParents[p]) {
+            _subtreeEnds[p] = static_cast<std::uint32_t>(_transformOrder.size());
+        }
+    } else {
+        _needsTransformOrderRebuild = true;
     }
 
     // add to dirty set
@@ -220,52 +502,110 @@ RenderEntity RenderWorld::addRenderEntity(const Transform& transform,
     return entity;
 }
 
-void RenderWorld::removeRenderEntity(RenderItemHandle handle) {
-    if (!_renderItemPool.valid(handle))
-        return;
+void RenderWorld::swapRemove(RenderIndex index) {
+    std::uint32_t slot = _transformSlots[index];
+    if (slot != NO_INDEX) {
+        _transformOrder[slot] = NO_INDEX;
+        // compact once most of the order is holes
+        if (++_removedTransformSlots > 64 && _removedTransformSlots > _transformOrder.size() / 2)
+            _needsTransformOrderRebuild = true;
+    }
 
-    // Remove children first
-    while (true) {
-        RenderItemHandle child = _renderItemPool.get(handle).firstChild;
-        if (child == RenderItemHandle::invalidHandle())
-            break;
-        removeRenderEntity(child);
-    }
-
-    RenderItem& item = _renderItemPool.get(handle);
-    RenderItemHandle parent = item.parent;
-
-    // Unlink from parent sibling chain
-    if (parent != RenderItemHandle::invalidHandle()) {
-        RenderItem& parentItem = _renderItemPool.get(parent);
-        if (parentItem.firstChild == handle) {
-            parentItem.firstChild = item.nextSibling;
-        } else {
-            RenderItemHandle cur = parentItem.firstChild;
-            while (cur != RenderItemHandle::invalidHandle()) {
-                RenderItem& curItem = _renderItemPool.get(cur);
-                if (curItem.nextSibling == handle) {
-                    curItem.nextSibling = item.nextSibling;
-                    break;
-                }
-                cur = curItem.nextSibling;
-            }
+    // both entries refer to indices that are about to change, the moved item gets a new one
+    RenderIndex last = static_cast<RenderIndex>(_handles.size() - 1);
+    markSortKeyDirty(index);
+    markSortKeyDirty(last);
+
+    removeSpatialProxy(index);
+
+    // move the last item into the hole
+    if (index != last) {
+        _handles[index] = _handles[last];
+        _worldBounds.copy(last, index);
+        _worldMatrices[index] = _worldMatrices[last];
+        _sortKeys[index] = _sortKeys[last];
+        _drawFlags[index] = _drawFlags[last];
+        _drawData[index] = _drawData[last];
+        _localTransforms[index] = _localTransforms[last];
+        _hierarchy[index] = _hierarchy[last];
+        _transformSlots[index] = _transformSlots[last];
+        _spatialProxies[index] = _spatialProxies[last];
+
+        _renderItemPool.get(_handles[index]).index = index;
+        if (_transformSlots[index] != NO_INDEX)
+            _transformOrder[_transformSlots[index]] = index;
+        if (_spatialProxies[index].node != AABBTree::NULL_NODE) {
+            AABBTree& tree = _spatialProxies[index].isStatic ? _staticTree : _dynamicTree;
+            tree.setUserData(_spatialProxies[index].node, index);
         }
-        handleDirtyTransform(parent);
     }
 
-    _dirtyTransforms.erase(handle);
+    _handles.pop_back();
+    _worldBounds.pop_back();
+    _worldMatrices.pop_back();
+    _sortKeys.pop_back();
+    _drawFlags.pop_back();
+    _drawData.pop_back();
+    _localTransforms.pop_back();
+    _hierarchy.pop_back();
+    _transformSlots.pop_back();
+    _spatialProxies.pop_back();
+}
+
+void RenderWorld::unlinkFromParent(RenderItemHandle handle) {
+    RenderHierarchy& item = _hierarchy[renderIndex(handle)];
+    if (item.parent == RenderItemHandle::invalidHandle())
+        return;
 
-    // Remove from dense active list by value, not handle.index
-    for (std::size_t i = 0; i < _activeRenderItems; ++i) {
-        if (_memoizedRenderItems[i] == handle) {
-            _memoizedRenderItems[i] = _memoizedRenderItems[_activeRenderItems - 1];
-            --_activeRenderItems;
-            break;
+    if (item.prevSibling != RenderItemHandle::invalidHandle())
+        _hierarchy[renderIndex(item.prevSibling)].nextSibling = item.nextSibling;
+    else
+        _hierarchy[renderIndex(item.parent)].firstChild = item.nextSibling;
+    if (item.nextSibling != RenderItemHandle::invalidHandle())
+        _hierarchy[renderIndex(item.nextSibling)].prevSibling = item.prevSibling;
+
+    item.parent = RenderItemHandle::invalidHandle();
+    item.prevSibling = RenderItemHandle::invalidHandle();
+    item.nextSibling = RenderItemHandle::invalidHandle();
+}
+
+void RenderWorld::removeSubtree(RenderItemHandle root) {
+    // once the root is cut off nothing outside links into the subtree, so its items can go in
+    // any order without fixing up their links
+    unlinkFromParent(root);
+
+    FrameVector<RenderItemHandle> stack(&FrameArena::local());
+    stack.push_back(root);
+    while (!stack.empty()) {
+        RenderItemHandle handle = stack.back();
+        stack.pop_back();
+
+        if (_drawData[renderIndex(handle)].isStatic)
+            markStaticChanged(handle);
+
+        for (RenderItemHandle c = _hierarchy[renderIndex(handle)].firstChild;
+            c != RenderItemHandle::invalidHandle();
+            c = _hierarchy[renderIndex(c)].nextSibling) {
+            stack.push_back(c);
         }
+
+        swapRemove(renderIndex(handle));
+        _renderItemPool.destroy(handle);
     }
+}
+
+void RenderWorld::removeRenderEntity(RenderItemHandle handle) {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    if (_renderItemPool.valid(handle))
+        removeSubtree(handle);
+}
 
-    _renderItemPool.destroy(handle);
+void RenderWorld::removeRenderEntities(std::span<const RenderEntity> entities) {
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    for (const RenderEntity& entity : entities) {
+        if (_renderItemPool.valid(entity._renderItem))
+            removeSubtree(entity._renderItem);
+    }
 }
 
 Failable RenderWorld::addChild(RenderEntity parent, RenderEntity children) {
@@ -276,8 +616,8 @@ Failable RenderWorld::addChild(RenderEntity parent, RenderEntity children) {
         return Failable::errorResult("Child render entity is invalid");
     }
 
-    RenderItem& parentItem = _renderItemPool.get(parent._renderItem);
-    RenderItem& childItem = _renderItemPool.get(children._renderItem);
+    RenderHierarchy& parentItem = _hierarchy[renderIndex(parent._renderItem)];
+    RenderHierarchy& childItem = _hierarchy[renderIndex(children._renderItem)];
 
     // now we need to check that the child item is not the parent of the parent item
     // to protect the invariant that there are no cycles in the scene graph
@@ -285,14 +625,25 @@ Failable RenderWorld::addChild(RenderEntity parent, RenderEntity children) {
         return Failable::errorResult("Cannot add child: would create cycle in scene graph");
     }
 
+    // a child that already has a parent moves over instead of ending up in two sibling lists
+    unlinkFromParent(children._renderItem);
+
     // link the child to the parent
     childItem.parent = parent._renderItem;
 
     childItem.nextSibling = parentItem.firstChild;  // invalid if none
+    if (parentItem.firstChild != RenderItemHandle::invalidHandle())
+        _hierarchy[renderIndex(parentItem.firstChild)].prevSibling = children._renderItem;
     parentItem.firstChild = children._renderItem;
 
-    // mark the transforms dirty
-    handleDirtyTransform(parent._renderItem);
+    // an item that already has a slot moves to its parent's subtree, new items are placed by
+    // addRenderEntity
+    if (_transformSlots[renderIndex(children._renderItem)] != NO_INDEX)
+        _needsTransformOrderRebuild = true;
+
+    // only roots are baked, the child now moves with its parent
+    if (_drawData[renderIndex(children._renderItem)].isStatic)
+        markStaticChanged(children._renderItem);
 
     return Failable::ok({});
 }
@@ -319,61 +670,281 @@ bool RenderWorld::isChildOf(RenderEntity parent, RenderEntity child) const {
 
 void RenderWorld::updateEntity(
     RenderItemHandle renderItem, const RenderEntity::Properties&& properties) {
+    applyUpdate(renderItem,
+        properties.transform,
+        properties.material,
+        properties.mesh,
+        properties.renderLayer,
+        properties.tint,
+        properties.isStatic);
+}
+
+void RenderWorld::updateEntities(std::span<const RenderEntityUpdate> updates) {
+    for (const RenderEntityUpdate& update : updates) {
+        applyUpdate(update.entity._renderItem,
+            update.transform,
+            update.material,
+            update.mesh,
+            update.renderLayer,
+            update.tint,
+            update.isStatic);
+    }
+}
+
+void RenderWorld::applyUpdate(RenderItemHandle renderItem,
+    const Transform& transform,
+    const MaterialHandle& material,
+    const Mesh& mesh,
+    std::uint8_t renderLayer,
+    const glm::vec4& tint,
+    bool isStatic) {
     if (!_renderItemPool.valid(renderItem)) {
         return;
     }
 
-    RenderItem& item = _renderItemPool.get(renderItem);
+    RenderIndex index = renderIndex(renderItem);
+    RenderDrawData& drawData = _drawData[index];
+    bool changed = drawData.isStatic != isStatic;
+    bool wasStatic = drawData.isStatic;
+    drawData.isStatic = isStatic;
 
     // check for changes and mark dirty as needed
-    if (item.material != properties.material || item.renderLayer != properties.renderLayer) {
-        item.material = properties.material;
-        item.renderLayer = properties.renderLayer;
+    if (drawData.material != material || drawData.renderLayer != renderLayer) {
+        drawData.material = material;
+        drawData.renderLayer = renderLayer;
         handleDirtyMaterial(renderItem);
+        changed = true;
     }
-    if (item.mesh != properties.mesh) {
-        item.mesh = properties.mesh;
+    if (drawData.mesh != mesh) {
+        drawData.mesh = mesh;
         handleDirtyMesh(renderItem);
+        changed = true;
+    }
+    // only read when recording, nothing to resort
+    if (drawData.tint != tint) {
+        drawData.tint = tint;
+        changed = true;
     }
-    if (item.transform != properties.transform) {
-        item.transform = properties.transform;
+    if (_localTransforms[index] != transform) {
+        _localTransforms[index] = transform;
+        handleDirtyTransform(renderItem);
+        changed = true;
     }
-    handleDirtyTransform(renderItem);
+
+    // last, dissolving a batch removes its item and moves indices around
+    if (changed && (isStatic || wasStatic))
+        markStaticChanged(renderItem);
 }
 
-// OkayRenderItem
+void RenderWorld::bakeStaticBatches(MeshBuffer& meshes) {
+    if (!_staticBatchesDirty || ++_staticSettleFrames < STATIC_BATCH_SETTLE_FRAMES)
+        return;
 
-inline std::uint64_t getBits(std::uint64_t value, std::uint32_t start, std::uint32_t end) {
-    return (value >> start) & ((1 << (end - start)) - 1);
+    AllocationScope allocations(MemoryTag::RENDER_WORLD);
+    // everything is baked again, static items rarely change and regrouping is cheap next to
+    // building the meshes
+    for (std::uint32_t batch = 0; batch < _staticBatches.size(); ++batch) {
+        dissolveStaticBatch(batch);
+    }
+    for (const Mesh& mesh : _releasedBatchMeshes) {
+        meshes.removeMesh(mesh);
+    }
+    _releasedBatchMeshes.clear();
+    _staticBatches.clear();
+    _staticBatchesDirty = false;
+
+    rebuildTransforms();
+
+    // keyed by material and layer, children move with their parent so only roots are baked
+    FrameVector<RenderSortEntry> candidates(&FrameArena::local());
+    for (RenderIndex index = 0; index < _handles.size(); ++index) {
+        const RenderDrawData& data = _drawData[index];
+        if (!data.isStatic || data.computeDrawFlags() != RenderDrawData::DRAWABLE ||
+            _hierarchy[index].parent != RenderItemHandle::invalidHandle())
+            continue;
+        std::uint64_t group = static_cast<std::uint64_t>(data.material.id) << 8 | data.renderLayer;
+        candidates.push_back(RenderSortEntry{group, index});
+    }
+    std::sort(candidates.begin(), candidates.end());
+
+    FrameVector<RenderIndex> items(&FrameArena::local());
+    FrameVector<std::pair<std::size_t, std::size_t>> ranges(&FrameArena::local());
+    for (std::size_t first = 0; first < candidates.size();) {
+        std::size_t last = first;
+        items.clear();
+        while (last < candidates.size() && candidates[last].key == candidates[first].key) {
+            items.push_back(candidates[last++].index);
+        }
+        first = last;
+
+        ranges.clear();
+        ranges.emplace_back(0, items.size());
+        while (!ranges.empty()) {
+            auto [begin, end] = ranges.back();
+            ranges.pop_back();
+            // a single item gains nothing from a batch
+            if (end - begin < 2)
+                continue;
+
+            std::size_t vertices = 0;
+            glm::vec3 low = _worldBounds.get(items[begin]).center();
+            glm::vec3 high = low;
+            for (std::size_t i = begin; i < end; ++i) {
+                vertices += _drawData[items[i]].mesh.vertexCount;
+                glm::vec3 center = _worldBounds.get(items[i]).center();
+                low = glm::min(low, center);
+                high = glm::max(high, center);
+            }
+            if (end - begin <= STATIC_BATCH_ITEMS && vertices <= STATIC_BATCH_VERTICES) {
+                bakeStaticBatch(meshes,
+                    std::span<const RenderIndex>(items.data() + begin, items.data() + end));
+                continue;
+            }
+
+            glm::vec3 size = high - low;
+            int axis = size.x >= size.y && size.x >= size.z ? 0 : (size.y >= size.z ? 1 : 2);
+            std::size_t middle = begin + (end - begin) / 2;
+            std::nth_element(items.begin() + begin,
+                items.begin() + middle,
+                items.begin() + end,
+                [&](RenderIndex a, RenderIndex b) {
+                    return _worldBounds.get(a).center()[axis] < _worldBounds.get(b).center()[axis];
+                });
+            ranges.emplace_back(begin, middle);
+            ranges.emplace_back(middle, end);
+        }
+    }
 }
 
-RenderItem::RenderItem(MaterialHandle mat, Mesh m) : material(mat), mesh(m) {
-    computeSortKey();
+void RenderWorld::bakeStaticBatch(MeshBuffer& meshes, std::span<const RenderIndex> items) {
+    MeshData merged;
+    Bounds bounds = Bounds::none();
+    bool hasBounds = false;
+    for (RenderIndex index : items) {
+        MeshData source = meshes.meshData(_drawData[index].mesh);
+        const glm::mat4& world = _worldMatrices[index];
+        glm::vec3 tint(_drawData[index].tint);
+        glm::mat3 linear(world);
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(linear));
+        // a mirroring transform turns the triangles around
+        bool mirrored = glm::dot(glm::cross(linear[0], linear[1]), linear[2]) < 0.0f;
+
+        std::uint32_t base = static_cast<std::uint32_t>(merged.vertices.size());
+        for (MeshVertex& vertex : source.vertices) {
+            vertex.position = glm::vec3(world * glm::vec4(vertex.position, 1.0f));
+            if (vertex.normal != glm::vec3(0.0f))
+                vertex.normal = glm::normalize(normalMatrix * vertex.normal);
+            vertex.color = vertex.color * tint;
+            if (!hasBounds)
+                bounds = Bounds(vertex.position, vertex.position);
+            bounds.extend(vertex.position);
+            hasBounds = true;
+            merged.vertices.push_back(vertex);
+        }
+        for (std::size_t i = 0; i + 2 < source.indices.size(); i += 3) {
+            merged.indices.push_back(base + source.indices[i]);
+            merged.indices.push_back(base + source.indices[mirrored ? i + 2 : i + 1]);
+            merged.indices.push_back(base + source.indices[mirrored ? i + 1 : i + 2]);
+        }
+    }
+
+    Mesh mesh = meshes.addMesh(merged);
+    mesh.bounds = bounds;
+
+    // copied, adding the batch's item grows the arrays
+    MaterialHandle material = _drawData[items.front()].material;
+    std::uint8_t renderLayer = _drawData[items.front()].renderLayer;
+    RenderEntity batch = addRenderEntity(Transform{}, material, mesh);
+    RenderDrawData& batchData = _drawData[renderIndex(batch._renderItem)];
+    batchData.renderLayer = renderLayer;
+    batchData.isStaticBatch = true;
+
+    std::uint32_t slot = static_cast<std::uint32_t>(_staticBatches.size());
+    StaticBatch& record = _staticBatches.emplace_back();
+    record.item = batch._renderItem;
+    record.mesh = mesh;
+    record.members.reserve(items.size());
+    for (RenderIndex index : items) {
+        record.members.push_back(_handles[index]);
+        _drawData[index].staticBatch = slot;
+        markSortKeyDirty(index);
+    }
 }
 
-void RenderItem::computeSortKey() {
-    if (material->isNone() || mesh.isEmpty()) {
-        sortKey = std::numeric_limits<std::uint64_t>::max();
+void RenderWorld::dissolveStaticBatch(std::uint32_t slot) {
+    StaticBatch& batch = _staticBatches[slot];
+    if (batch.item == RenderItemHandle::invalidHandle())
         return;
+
+    for (RenderItemHandle member : batch.members) {
+        if (!_renderItemPool.valid(member))
+            continue;
+        RenderIndex index = renderIndex(member);
+        _drawData[index].staticBatch = RenderDrawData::NO_STATIC_BATCH;
+        markSortKeyDirty(index);
+    }
+
+    RenderItemHandle item = batch.item;
+    _releasedBatchMeshes.push_back(batch.mesh);
+    batch = StaticBatch{};
+    if (_renderItemPool.valid(item))
+        removeSubtree(item);
+    _staticBatchesDirty = true;
+}
+
+void RenderWorld::markStaticChanged(RenderItemHandle handle) {
+    // the batch shows the old state, its members are drawn on their own until the next bake
+    std::uint32_t batch = _drawData[renderIndex(handle)].staticBatch;
+    if (batch != RenderDrawData::NO_STATIC_BATCH)
+        dissolveStaticBatch(batch);
+    _staticBatchesDirty = true;
+    _staticSettleFrames = 0;
+}
+
+// OkayRenderDrawData
+
+std::uint64_t RenderDrawData::computeSortKey() const {
+    if (!material.isValid() || material->isNone() || mesh.isEmpty()) {
+        return std::numeric_limits<std::uint64_t>::max();
     }
 
     bool opaque = !material->properties()->flags().hasFlag(MaterialFlags::TRANSPARENT);
 
     std::uint64_t transparentBit = opaque ? 0ULL : 1ULL;
     std::uint64_t layer = static_cast<std::uint64_t>(this->renderLayer) & 0xFFULL;
-    std::uint64_t shaderID = material->shaderID() & ((1ULL << 27) - 1ULL);
-    std::uint64_t materialID = material->id() & ((1ULL << 27) - 1ULL);
+    std::uint64_t shaderID = material->shaderID() & ((1ULL << 16) - 1ULL);
+    std::uint64_t materialID = material->id() & ((1ULL << 20) - 1ULL);
+    std::uint64_t meshID = static_cast<std::uint64_t>(mesh.indexOffset) & ((1ULL << 19) - 1ULL);
 
     // Layout (MSB → LSB):
     // [63]     transparentBit   opaque = 0, transparent = 1
     // [62..55] renderLayer      lower layer = earlier
-    // [54..28] shaderID
-    // [27..1]  materialID
-    // [0]      unused
-
-    sortKey = 0;
+    // [54..39] shaderID
+    // [38..19] materialID
+    // [18..0]  meshID           first index of the mesh, keeps copies of a mesh next to each
+    //                           other so they can be drawn instanced
+    //
+    // truncated fields that collide only cost grouping, the executor compares the real values
+
+    std::uint64_t sortKey = 0;
     sortKey |= transparentBit << 63;
     sortKey |= layer << 55;
-    sortKey |= shaderID << 28;
-    sortKey |= materialID << 1;
+    sortKey |= shaderID << 39;
+    sortKey |= materialID << 19;
+    sortKey |= meshID;
+    return sortKey;
+}
+
+std::uint8_t RenderDrawData::computeDrawFlags() const {
+    if (!material.isValid() || material->isNone() || mesh.isEmpty())
+        return 0;
+
+    // drawn by its batch
+    if (staticBatch != NO_STATIC_BATCH)
+        return 0;
+
+    std::uint8_t flags = DRAWABLE;
+    if (material->properties()->flags().hasFlag(MaterialFlags::SCREEN_SPACE))
+        flags |= SCREEN_SPACE;
+    return flags;
 }
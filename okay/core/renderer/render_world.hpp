@@ -5,18 +5,22 @@
 #include "glm/ext/vector_float4.hpp"
 #include "math_types.hpp"
 
+#include <okay/core/renderer/aabb_tree.hpp>
+#include <okay/core/renderer/culling.hpp>
 #include <okay/core/renderer/gl.hpp>
 #include <okay/core/renderer/material.hpp>
 #include <okay/core/renderer/mesh.hpp>
 #include <okay/core/util/dirty_set.hpp>
 #include <okay/core/util/object_pool.hpp>
+#include <okay/core/util/option.hpp>
 #include <okay/core/util/property.hpp>
 
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/quaternion.hpp>
-#include <set>
+#include <limits>
+#include <span>
 #include <variant>
 #include <vector>
 
@@ -95,12 +99,22 @@ class Camera {
                clip.z >= -clip.w && clip.z <= clip.w;
     }
 
-    bool isInFrustum(const Bounds& bounds, float aspectRatio) {
-        for (const glm::vec3& p : bounds.corners()) {
-            if (!isInFrustum(p, aspectRatio))
-                return false;
-        }
-        return true;
+    // extract once per frame and test against that, isInFrustum rebuilds it on every call
+    Frustum frustum(float aspectRatio) const {
+        return Frustum::fromMatrix(projectionMatrix(aspectRatio) * viewMatrix());
+    }
+
+    bool isInFrustum(const Bounds& bounds, float aspectRatio) const {
+        return frustum(aspectRatio).intersects(bounds);
+    }
+
+    // world space ray through a point in normalized device coordinates, for picking
+    Ray screenRay(const glm::vec2& ndc, float aspectRatio) const {
+        glm::mat4 inverse = glm::inverse(projectionMatrix(aspectRatio) * viewMatrix());
+        glm::vec4 nearPoint = inverse * glm::vec4(ndc.x, ndc.y, -1.0f, 1.0f);
+        glm::vec4 farPoint = inverse * glm::vec4(ndc.x, ndc.y, 1.0f, 1.0f);
+        glm::vec3 origin = glm::vec3(nearPoint) / nearPoint.w;
+        return Ray{origin, glm::normalize(glm::vec3(farPoint) / farPoint.w - origin)};
     }
 
     operator Transform() const {
@@ -183,43 +197,59 @@ class RenderWorld;
 
 using RenderItemHandle = ObjectPoolHandle;
 
-struct RenderItem {
-    MaterialHandle material;
-    Mesh mesh;
-    Transform transform;
-    std::uint8_t renderLayer;
-    std::uint64_t sortKey;
-    glm::mat4 worldMatrix{1.0f};
+// position of a render item in the RenderWorld's dense arrays, it changes when other items are
+// removed so hold on to a RenderItemHandle instead
+using RenderIndex = std::uint32_t;
+
+// what a draw needs besides the world matrix, only read for items that get submitted
+struct RenderDrawData {
+    MaterialHandle material{MaterialHandle::none()};
+    Mesh mesh{Mesh::none()};
+    std::uint8_t renderLayer{0};
+    // multiplies the material color, per object so it doesn't split instanced draws
+    glm::vec4 tint{1.0f};
+    // never changes after it is set up, so it can be baked into a static batch
+    bool isStatic{false};
+    // one of the merged meshes static items are baked into, never in the spatial trees
+    bool isStaticBatch{false};
+    // the batch that draws this item in its place
+    std::uint32_t staticBatch{NO_STATIC_BATCH};
+
+    static constexpr std::uint32_t NO_STATIC_BATCH = 0xFFFFFFFFu;
+
+    // has a mesh and a material to draw with
+    static constexpr std::uint8_t DRAWABLE = 1 << 0;
+    // drawn in screen space, so never culled
+    static constexpr std::uint8_t SCREEN_SPACE = 1 << 1;
+
+    std::uint64_t computeSortKey() const;
+    std::uint8_t computeDrawFlags() const;
+};
 
+// one entry of the draw order, ordered by key with the index breaking ties
+struct RenderSortEntry {
+    std::uint64_t key{0};
+    RenderIndex index{0};
+
+    bool operator<(const RenderSortEntry& other) const {
+        return key < other.key || (key == other.key && index < other.index);
+    }
+    bool operator==(const RenderSortEntry& other) const {
+        return key == other.key && index == other.index;
+    }
+};
+
+// links are handles so they stay valid while dense indices move
+struct RenderHierarchy {
     RenderItemHandle parent{RenderItemHandle::invalidHandle()};
     RenderItemHandle firstChild{RenderItemHandle::invalidHandle()};
-    RenderItemHandle previousSibling{RenderItemHandle::invalidHandle()};
+    RenderItemHandle prevSibling{RenderItemHandle::invalidHandle()};
     RenderItemHandle nextSibling{RenderItemHandle::invalidHandle()};
+};
 
-    RenderItem() = default;
-    RenderItem(MaterialHandle mat, Mesh m);
-
-    void computeSortKey();
-
-    // operator overloads for std::map
-    bool operator<(const RenderItem& other) const {
-        return sortKey < other.sortKey;
-    }
-    bool operator>(const RenderItem& other) const {
-        return sortKey > other.sortKey;
-    }
-    bool operator==(const RenderItem& other) const {
-        return sortKey == other.sortKey;
-    }
-    bool operator!=(const RenderItem& other) const {
-        return !(*this == other);
-    }
-    bool operator<=(const RenderItem& other) const {
-        return sortKey <= other.sortKey;
-    }
-    bool operator>=(const RenderItem& other) const {
-        return sortKey >= other.sortKey;
-    }
+// the pool entry behind a RenderItemHandle, the item's state lives in the dense arrays
+struct RenderItem {
+    RenderIndex index{0};
 };
 
 struct RenderEntity {
@@ -232,6 +262,8 @@ struct RenderEntity {
         Transform transform{};
         Mesh mesh{};
         std::uint8_t renderLayer{0};
+        glm::vec4 tint{1.0f};
+        bool isStatic{false};
 
         ~Properties();
         Properties* operator->() {
@@ -276,6 +308,22 @@ struct RenderEntity {
     RenderItemHandle _renderItem{RenderItemHandle::invalidHandle()};
 };
 
+// the full state of one render entity, submitted in batches through RenderWorld::updateEntities
+struct RenderEntityUpdate {
+    RenderEntity entity;
+    Transform transform{};
+    MaterialHandle material{};
+    Mesh mesh{};
+    std::uint8_t renderLayer{0};
+    glm::vec4 tint{1.0f};
+    bool isStatic{false};
+};
+
+struct RenderRayHit {
+    RenderEntity entity;
+    float distance{0.0f};
+};
+
 class RenderWorld {
    public:
     struct ChildIterator {
@@ -331,22 +379,72 @@ class RenderWorld {
             transform, material, mesh, RenderEntity(this, RenderItemHandle::invalidHandle()));
     }
 
-    const std::span<RenderItemHandle> getRenderItems();
-    const RenderItem& getRenderItem(RenderItemHandle handle) const {
-        return _renderItemPool.get(handle);
+    // every item ordered by sort key, brings world matrices and bounds up to date
+    std::span<const RenderSortEntry> drawOrder();
+
+    // Fills drawList with the drawable items that intersect the frustum, and every screen space
+    // item, ordered by sort key. Culling walks the static and dynamic trees split into subtrees
+    // on the job system, then the draw order is filtered in chunks. Returns how many drawable
+    // items were culled.
+    std::size_t buildDrawList(const Frustum& frustum, std::vector<RenderSortEntry>& drawList);
+
+    // Merges static root items that share a material and layer into meshes pre-transformed to
+    // world space, split into spatial clusters so they still cull. The merged items keep their
+    // place in the world for queries but are drawn by their batch. Runs once the static items
+    // have been left alone for a while, a change to one of them dissolves its batch right away.
+    void bakeStaticBatches(MeshBuffer& meshes);
+
+    // the dense item arrays, indexed by RenderIndex and only up to date after drawOrder()
+    std::span<const glm::mat4> worldMatrices() const {
+        return _worldMatrices;
+    }
+    const CullBounds& worldBounds() const {
+        return _worldBounds;
+    }
+    std::span<const std::uint64_t> sortKeys() const {
+        return _sortKeys;
+    }
+    std::span<const std::uint8_t> drawFlags() const {
+        return _drawFlags;
     }
+    std::span<const RenderDrawData> drawData() const {
+        return _drawData;
+    }
+
+    // Spatial queries over the world bounds, results are dense indices. Items that haven't moved
+    // for a while live in a static tree that is never refit, the rest in a dynamic tree whose
+    // fat leaves absorb small moves.
+    void queryFrustum(const Frustum& frustum, std::vector<RenderIndex>& visible);
+    void queryOverlap(const Bounds& bounds, std::vector<RenderIndex>& overlapping);
+    void queryOverlap(const Sphere& sphere, std::vector<RenderIndex>& overlapping);
+    // closest item with a mesh whose world bounds the ray hits
+    Option<RenderRayHit> raycast(
+        const Ray& ray, float maxDistance = std::numeric_limits<float>::max());
 
-    RenderItem& getRenderItem(RenderItemHandle handle) {
-        return _renderItemPool.get(handle);
+    RenderIndex renderIndex(RenderItemHandle handle) const {
+        return _renderItemPool.get(handle).index;
+    }
+    RenderItemHandle renderHandle(RenderIndex index) const {
+        return _handles[index];
+    }
+    const glm::mat4& worldMatrix(RenderItemHandle handle) const {
+        return _worldMatrices[renderIndex(handle)];
     }
+
     RenderEntity getRenderEntity(RenderItemHandle handle) {
         return RenderEntity(this, handle);
     }
     void updateEntity(RenderItemHandle renderItem, const RenderEntity::Properties&& properties);
+    // only the fields that differ from the current state mark an item dirty, so resubmitting
+    // an unchanged entity is just a comparison
+    void updateEntities(std::span<const RenderEntityUpdate> updates);
     void removeRenderEntity(RenderEntity entity) {
         removeRenderEntity(entity._renderItem);
     }
     void removeRenderEntity(RenderItemHandle renderItem);
+    // removes every entity together with its subtree, entities that are already gone, like
+    // descendants of an earlier entry, are skipped
+    void removeRenderEntities(std::span<const RenderEntity> entities);
     bool isValidEntity(const RenderItemHandle& renderItem) const {
         return _renderItemPool.valid(renderItem);
     }
@@ -354,7 +452,7 @@ class RenderWorld {
         return _renderItemPool.valid(entity._renderItem);
     }
     std::size_t numRenderItems() const {
-        return _activeRenderItems;
+        return _handles.size();
     }
 
     Failable addChild(RenderEntity parent, RenderEntity children);
@@ -379,19 +477,136 @@ class RenderWorld {
     }
 
    private:
+    friend struct RenderEntity;
+
+    static constexpr std::uint32_t NO_INDEX = 0xFFFFFFFFu;
+
     ObjectPool<RenderItem> _renderItemPool;
-    std::vector<RenderItemHandle> _memoizedRenderItems;
-    std::set<RenderItemHandle> _dirtyTransforms;
-    std::size_t _activeRenderItems{0};
+
+    // Item state split by how the pipeline reads it, all indexed by RenderIndex and kept dense
+    // by swap-removing. Culling streams bounds and world matrices, sorting only touches the keys
+    // and submission reads the draw data of the visible items.
+    std::vector<RenderItemHandle> _handles;
+    CullBounds _worldBounds;
+    std::vector<glm::mat4> _worldMatrices;
+    std::vector<std::uint64_t> _sortKeys;
+    // RenderDrawData flags, computed together with the sort key
+    std::vector<std::uint8_t> _drawFlags;
+    std::vector<RenderDrawData> _drawData;
+    std::vector<Transform> _localTransforms;
+    std::vector<RenderHierarchy> _hierarchy;
+    // RenderIndex -> slot in _transformOrder
+    std::vector<std::uint32_t> _transformSlots;
+
+    // Sorted (key, index) entries. A full rebuild radix sorts every key, otherwise the entries
+    // of changed items are dropped and their new ones merged in. A live item has an entry
+    // unless it is in _dirtySortKeys, and _sortKeys holds the key of that entry.
+    std::vector<RenderSortEntry> _drawOrder;
+    std::vector<RenderSortEntry> _drawOrderScratch;
+    std::vector<RenderSortEntry> _staleSortEntries;
+    DirtySet<RenderIndex> _dirtySortKeys;
+    bool _needsDrawOrderRebuild{true};
+
+    // Draw order entries per filter job. Every chunk writes its draws to its own range of the
+    // draw list and they are compacted afterwards, so the list comes out the same on any thread
+    // count.
+    static constexpr std::size_t DRAW_LIST_CHUNK = 1024;
+    // levels the trees are split down before culling, up to 2^n subtree jobs per tree
+    static constexpr int CULL_SPLIT_DEPTH = 5;
+    // keys are cheap, only big rebuilds are worth spreading out
+    static constexpr std::size_t SORT_KEY_CHUNK = 4096;
+
+    struct DrawListChunk {
+        std::uint32_t drawCount{0};
+        std::uint32_t culledCount{0};
+    };
+
+    std::vector<DrawListChunk> _drawListChunks;
+    // subtrees of each tree that the last cull walked as separate jobs
+    std::vector<AABBTree::Proxy> _staticCullPieces;
+    std::vector<AABBTree::Proxy> _dynamicCullPieces;
+    // whether each item made it into the last draw list, indexed by RenderIndex
+    std::vector<std::uint8_t> _drawnItems;
+
+    // The hierarchy flattened in depth first order, so a parent's slot always comes before its
+    // children's and every subtree is the contiguous range [slot, _subtreeEnds[slot]). World
+    // matrices are propagated in one forward pass over the dirty subtrees. Removed items leave
+    // NO_INDEX in their slot until the order is rebuilt.
+    std::vector<RenderIndex> _transformOrder;
+    std::vector<std::uint32_t> _transformParents;
+    std::vector<std::uint32_t> _subtreeEnds;
+    DirtyBitset _dirtyTransforms;
+    std::size_t _removedTransformSlots{0};
+    bool _needsTransformOrderRebuild{false};
+
+    struct SpatialProxy {
+        AABBTree::Proxy node{AABBTree::NULL_NODE};
+        bool isStatic{false};
+        std::uint32_t lastMoved{0};
+    };
+
+    static constexpr float DYNAMIC_TREE_MARGIN = 0.25f;
+    // frames without moving before an item is moved into the static tree, checked every
+    // STATIC_SWEEP_INTERVAL frames
+    static constexpr std::uint32_t STATIC_AFTER_FRAMES = 60;
+    static constexpr std::uint32_t STATIC_SWEEP_INTERVAL = 16;
+
+    AABBTree _staticTree{0.0f};
+    AABBTree _dynamicTree{DYNAMIC_TREE_MARGIN};
+    std::vector<SpatialProxy> _spatialProxies;
+    std::uint32_t _spatialFrame{0};
+
+    struct StaticBatch {
+        RenderItemHandle item{RenderItemHandle::invalidHandle()};
+        Mesh mesh{};
+        std::vector<RenderItemHandle> members;
+    };
+
+    // Baked batches hold at most this many items and vertices. Bigger groups are split at the
+    // median along the longest axis of their centers, so batches stay compact enough to cull.
+    static constexpr std::size_t STATIC_BATCH_ITEMS = 64;
+    static constexpr std::size_t STATIC_BATCH_VERTICES = 1 << 16;
+    // frames without changes to static items before they are baked again
+    static constexpr std::uint32_t STATIC_BATCH_SETTLE_FRAMES = 30;
+
+    std::vector<StaticBatch> _staticBatches;
+    // meshes of dissolved batches, freed on the next bake where the mesh buffer is at hand
+    std::vector<Mesh> _releasedBatchMeshes;
+    bool _staticBatchesDirty{false};
+    std::uint32_t _staticSettleFrames{0};
 
     std::array<Light, Light::MAX_LIGHTS> _lights{};
     std::size_t _activeLights{0};
 
-    bool _needsMaterialRebuild{true};
     Camera _camera;
 
+    void rebuildTransformOrder();
     void rebuildTransforms();
-    void rebuildMaterials();
+    void rebuildDrawOrder();
+    void patchDrawOrder();
+    void markSortKeyDirty(RenderIndex index);
+
+    void appendTransformSlot(RenderIndex index, std::uint32_t parentSlot);
+    void swapRemove(RenderIndex index);
+    void unlinkFromParent(RenderItemHandle handle);
+    void updateSpatialProxy(RenderIndex index, const Bounds& bounds);
+    void removeSpatialProxy(RenderIndex index);
+    void promoteStaticItems();
+    template <typename Shape>
+    void queryTrees(const Shape& shape, std::vector<RenderIndex>& out);
+    void removeSubtree(RenderItemHandle root);
+
+    void bakeStaticBatch(MeshBuffer& meshes, std::span<const RenderIndex> items);
+    void dissolveStaticBatch(std::uint32_t batch);
+    void markStaticChanged(RenderItemHandle handle);
+
+    void applyUpdate(RenderItemHandle renderItem,
+        const Transform& transform,
+        const MaterialHandle& material,
+        const Mesh& mesh,
+        std::uint8_t renderLayer,
+        const glm::vec4& tint,
+        bool isStatic);
 
     void handleDirtyMesh(RenderItemHandle dirtyEntity);
     void handleDirtyMaterial(RenderItemHandle dirtyEntity);
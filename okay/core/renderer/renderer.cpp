@@ -101,6 +101,7 @@ void Renderer::preTick() {
 }
 
 void Renderer::tick() {
+    _world.bakeStaticBatches(_meshBuffer);
     _meshBuffer.bindMeshData();
     _surface->pollEvents();
     RendererContext context{*this, _world, _renderTargetPool};
@@ -111,6 +112,8 @@ void Renderer::postTick() {
     if (_imguiImpl->imguiSupported() && _imguiEnabled && _imguiInitialized) {
         ImGui::Render();
         _imguiImpl->renderDrawData(ImGui::GetDrawData());
+        // the imgui backend sets GL state behind the cache's back
+        GPUState::instance().gl.invalidate();
     }
 
     _surface->swapBuffers();
@@ -9,6 +9,9 @@
 #include <cstddef>
 #include <cstdint>
 #include <glm/glm.hpp>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 namespace okay {
 
@@ -58,68 +61,70 @@ class Shader {
         return _shaderProgram;
     }
 
-    GLuint findUniformLocation(const std::string& uniform) {
-        auto it = _uniforms.find(uniform);
-        if (it != _uniforms.end()) {
-            return it->second.location;
+    // reads its model matrices from the instances block instead of u_modelMatrix
+    bool instanced() const {
+        return _instanced;
+    }
+
+    // reads the camera from the view block instead of the scene uniforms
+    bool sharedView() const {
+        return _sharedView;
+    }
+
+    // index of a uniform in the shader's slots, names are only looked up when resolving one
+    using UniformSlot = std::uint32_t;
+
+    // finds the slot of a uniform, adding it the first time it's asked for. Slots stay valid for
+    // the shader's lifetime, callers resolve them once and keep them. Optional uniforms the
+    // program doesn't have get an inactive slot without a warning
+    UniformSlot resolveUniformSlot(const std::string& uniform, bool optional = false) {
+        auto it = _slotIndices.find(uniform);
+        if (it != _slotIndices.end()) {
+            return it->second;
         }
 
         GLuint location = glGetUniformLocation(_shaderProgram, uniform.c_str());
         if (location == -1) {
-            Engine.logger.warn("Failed to find uniform location for '{}'", uniform);
+            if (!optional)
+                Engine.logger.warn("Failed to find uniform location for '{}'", uniform);
             location = uni::inactiveLocation();
-        } else {
-            // Engine.logger.debug("Found uniform location for '{}': {}", uniform, location);
         }
 
-        // add to map
-        UniformInfo info{
+        UniformSlot slot = static_cast<UniformSlot>(_slots.size());
+        _slots.push_back({
             .location = location,
             .value = uni::UniformValue::none(),
-        };
-        _uniforms[uniform] = info;
+        });
+        _slotIndices.emplace(uniform, slot);
+        return slot;
+    }
 
-        return location;
+    GLuint slotLocation(UniformSlot slot) const {
+        return _slots[slot].location;
+    }
+
+    GLuint findUniformLocation(const std::string& uniform) {
+        return slotLocation(resolveUniformSlot(uniform));
     }
 
+    // the shader remembers the last value of every slot and skips setting it again
     template <class T>
-    Failable setUniform(const std::string& uniform, const T& value) {
-        auto it = _uniforms.find(uniform);
-
-        // If we have this uniform already, then we only need to
-        // grab the info once
-        if (it != _uniforms.end()) {
-            UniformInfo& info = it->second;
-            if (info.location == uni::inactiveLocation()) {
-                return Failable::ok({});
-            }
-
-            if (info.value == value) {
-                return Failable::ok({});
-            }
-
-            uni::set(info.location, value);
-            info.value = value;
+    Failable setUniform(UniformSlot slot, const T& value) {
+        UniformInfo& info = _slots[slot];
+        if (info.location == uni::inactiveLocation() || info.value == value) {
             return Failable::ok({});
         }
 
-        // We don't have this uniform yet, so we need to find it
-        auto location = findUniformLocation(uniform);
-        if (location == uni::inactiveLocation()) {
-            return Failable::ok({});
-        };
-
-        // add to map
-        UniformInfo& info = _uniforms[uniform];
-        info.location = location;
+        uni::set(info.location, value);
         info.value = value;
-
-        // Engine.logger.debug("Setting uniform '{}': {}", uniform, location);
-        uni::set(location, value);
-
         return Failable::ok({});
     }
 
+    template <class T>
+    Failable setUniform(const std::string& uniform, const T& value) {
+        return setUniform(resolveUniformSlot(uniform), value);
+    }
+
     // enable equality operator
     bool operator==(const Shader& other) const {
         return _shaderProgram == other._shaderProgram && _state == other._state &&
@@ -140,8 +145,13 @@ class Shader {
     GLuint _shaderProgram;
     State _state;
     std::size_t _srcHash;
+    bool _instanced{false};
+    bool _sharedView{false};
+
+    std::vector<UniformInfo> _slots;
+    std::unordered_map<std::string, UniformSlot> _slotIndices;
 
-    std::unordered_map<std::string, UniformInfo> _uniforms;
+    Failable buildFromSource();
 };
 
 class MaterialRegistry;
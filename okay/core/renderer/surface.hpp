@@ -4,6 +4,7 @@
 #include <okay/core/engine/system.hpp>
 #include <okay/core/renderer/gl.hpp>
 
+#include <cstdint>
 #include <memory>
 
 namespace okay {
@@ -14,6 +15,9 @@ struct SurfaceConfig {
     const char* title{"Okay Surface"};
     bool resizable{true};
     bool vsync{false};
+    // close after this many presented frames, 0 runs until the surface is closed.
+    // only the headless backend honors it
+    std::uint32_t maxFrames{0};
 };
 
 class Surface {
@@ -30,6 +34,10 @@ class Surface {
     void destroy();
     void* getWindow();
 
+    // the backend's GL function lookup, for entry points the vendored loader doesn't cover.
+    // needs a current context and may return a stub for names the driver doesn't implement
+    static void* getProcAddress(const char* name);
+
    private:
     struct SurfaceImpl;                  // defined in the backend .cpp
     std::unique_ptr<SurfaceImpl> _impl;  // opaque to callers
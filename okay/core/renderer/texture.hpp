@@ -1,6 +1,7 @@
 #ifndef __TEXTURE_H__
 #define __TEXTURE_H__
 
+#include <okay/core/engine/memory_tracker.hpp>
 #include <okay/core/renderer/gl.hpp>
 #include <okay/core/util/result.hpp>
 
@@ -58,12 +59,14 @@ class TextureDataStore {
     }
 
     TextureHandle addTexture(OkayTextureMeta meta, std::span<const std::byte> data) {
+        AllocationScope allocations(MemoryTag::TEXTURES);
         TextureHandle handle = storeTextureData(data);
         _metaMap[handle] = meta;
         return handle;
     }
 
     TextureHandle addTexture(std::size_t size) {
+        AllocationScope allocations(MemoryTag::TEXTURES);
         TextureHandle handle = getBlock(size);
         _metaMap[handle] = OkayTextureMeta{};
         return handle;
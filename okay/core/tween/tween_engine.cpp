@@ -1,5 +1,7 @@
 #include "tween_engine.hpp"
 
+#include <okay/core/util/frame_arena.hpp>
+
 using namespace okay;
 
 void TweenEngine::addTween(std::shared_ptr<ITween> tween) {
@@ -7,7 +9,7 @@ void TweenEngine::addTween(std::shared_ptr<ITween> tween) {
 }
 
 void TweenEngine::tick() {
-    std::vector<std::uint64_t> tweenIndicesToErase;
+    FrameVector<std::uint64_t> tweenIndicesToErase(&FrameArena::local());
     for (std::uint64_t i{}; i < _activeTweens.size(); ++i) {
         std::shared_ptr<ITween>& tween{_activeTweens[i]};
 
@@ -18,6 +18,7 @@ FontManager::FontManager() {
 
 Option<FontHandle> FontManager::loadFont(
     const std::string& fontPath, const FontLoadOptions& options) {
+    AllocationScope allocations(MemoryTag::FONTS);
     if (_fontFaces.find(fontPath) != _fontFaces.end()) {
         return Option<FontHandle>::some(FontHandle{_fontFaces[fontPath]});
     }
@@ -57,8 +57,9 @@ class TextMeshBuffer {
 
         if (quadsUsed <= meta.maxQuads) {
             // this is easy, we can simply reuse the mesh
-            MeshData textMeshData = TextMeshBuilder::build(text, style, false);
-            Result<Mesh> updated = _renderer->meshBuffer().updateMesh(meta.mesh, textMeshData);
+            TextMeshBuilder::build(text, style, false, _scratch);
+            Engine.stats.add(Stat::TEXT_MESHES_REBUILT);
+            Result<Mesh> updated = _renderer->meshBuffer().updateMesh(meta.mesh, _scratch);
 
             if (updated.isError()) {
                 Engine.logger.error("Failed to update text mesh! Error: {}", updated.error());
@@ -80,9 +81,10 @@ class TextMeshBuffer {
         meta.mesh = mesh;
         meta.maxQuads = newQuadSize;
 
-        MeshData textMeshData = TextMeshBuilder::build(text, style, false);
+        TextMeshBuilder::build(text, style, false, _scratch);
+        Engine.stats.add(Stat::TEXT_MESHES_REBUILT);
 
-        Result<Mesh> updated = _renderer->meshBuffer().updateMesh(meta.mesh, textMeshData);
+        Result<Mesh> updated = _renderer->meshBuffer().updateMesh(meta.mesh, _scratch);
         if (updated.isError()) {
             Engine.logger.error("Failed to update text mesh! Error: {}", updated.error());
             return;
@@ -103,6 +105,8 @@ class TextMeshBuffer {
 
     ObjectPool<TextMeshMeta> _textMeshPool;
     SystemParameter<Renderer> _renderer;
+    // rebuilt text is staged here so its vertex and index storage is reused between updates
+    MeshData _scratch;
 };
 
 };  // namespace okay
@@ -51,10 +51,18 @@ TextMeshBuilder::TextQuad TextMeshBuilder::generateQuadForGlyph(
 }
 
 MeshData TextMeshBuilder::build(std::string_view text, const TextStyle& style, bool doubleSided) {
+    MeshData meshData;
+    build(text, style, doubleSided, meshData);
+    return meshData;
+}
+
+void TextMeshBuilder::build(
+    std::string_view text, const TextStyle& style, bool doubleSided, MeshData& meshData) {
     FontManager& fontManager = FontManager::instance();
     const TextLayout layout(text, style);
 
-    MeshData meshData;
+    meshData.vertices.clear();
+    meshData.indices.clear();
     meshData.vertices.reserve(layout.metrics().glyphCount * 4);
     meshData.indices.reserve(layout.metrics().glyphCount * (doubleSided ? 12 : 6));
 
@@ -86,8 +94,6 @@ MeshData TextMeshBuilder::build(std::string_view text, const TextStyle& style, b
             baselineX += static_cast<float>(glyph.advance) * glyphScale;
         }
     }
-
-    return meshData;
 }
 
 }  // namespace okay
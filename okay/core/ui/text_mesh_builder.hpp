@@ -15,6 +15,10 @@ class TextMeshBuilder {
    public:
     static MeshData build(std::string_view text, const TextStyle& style, bool doubleSided);
 
+    // same as build, but reuses the storage of out instead of allocating a new MeshData
+    static void build(
+        std::string_view text, const TextStyle& style, bool doubleSided, MeshData& out);
+
    private:
     struct TextQuad {
         MeshVertex vertices[4];
@@ -8,6 +8,7 @@
 #include <okay/core/engine/engine.hpp>
 #include <okay/core/renderer/renderer.hpp>
 #include <okay/core/util/format.hpp>
+#include <okay/core/util/frame_arena.hpp>
 #include <okay/core/util/variant.hpp>
 
 #include <variant>
@@ -95,8 +96,7 @@ void UILayout::computeFixedSizes(UINode& node, LayoutRect parent) {
 UI::UI() : _textMeshBuffer() {}
 
 UI::UI(UIElement root) : _textMeshBuffer() {
-    _root = createNodeFromElement(root, 0);
-    _layout = UILayout(_root);
+    _layout = UILayout(createNodeFromElement(root, 0));
 }
 
 void UILayout::computeFitSizes(UINode& node, LayoutRect parent) {
@@ -244,6 +244,7 @@ void UILayout::computeFitSizes(UINode& node, LayoutRect parent) {
 }
 
 void UILayout::computePositions(UINode& node, LayoutRect parent) {
+    Engine.stats.add(Stat::UI_NODES_LAID_OUT);
     LayoutRect& rect = getOrMakeRect(node);
     const UIElement& element = node.element;
 
@@ -387,31 +388,36 @@ void UILayout::toString(std::stringstream& ss, const UINode& node, int indent) c
 
 void UI::render(
     glm::vec2 screenPosition, std::uint8_t uiLayer, SystemParameter<Renderer> renderer) {
+    AllocationScope allocations(MemoryTag::UI);
     UILayout::Context layoutContext{
         .screenSize = glm::ivec2(renderer->width(), renderer->height()),
     };
     _layout.layout(layoutContext);
-    renderNode(_root, *renderer, (0x1 << 7) + 1 + (uiLayer * 24));
+    renderNode(_layout.root(), *renderer, (0x1 << 7) + 1 + (uiLayer * 24));
 
+    // nodes that disappeared in the last update, their entities go in one batch
+    FrameVector<RenderEntity> removed(&FrameArena::local());
     for (auto it = _nodeRenderInfo.begin(); it != _nodeRenderInfo.end();) {
         UINode::ID id = it->first;
 
         if (id >= _nextNodeID) {
-            it->second.rectEntity.remove();
-            it->second.textEntity.remove();
+            removed.push_back(it->second.rectEntity);
+            removed.push_back(it->second.textEntity);
             it = _nodeRenderInfo.erase(it);
         } else {
             ++it;
         }
     }
+    renderer->world().removeRenderEntities(removed);
 }
 
 void UI::update(UIElement newRoot) {
+    AllocationScope allocations(MemoryTag::UI);
     // reset node ID
     // Engine.logger.debug("Updating UI!");
     _nextNodeID = 1;
-    _root = createNodeFromElement(newRoot, 0);
-    _layout.update(_root);
+    // the layout owns the node tree, so it's built once per update instead of copied
+    _layout.update(createNodeFromElement(newRoot, 0));
 }
 
 void UI::renderNode(const UINode& node, Renderer& renderer, int layerBase) {
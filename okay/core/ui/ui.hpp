@@ -44,14 +44,18 @@ struct LayoutRect {
 class UILayout {
    public:
     UILayout() = default;
-    UILayout(UINode root) : _root(root) {}
+    UILayout(UINode root) : _root(std::move(root)) {}
 
     struct Context {
         glm::ivec2 screenSize;
     };
 
     void update(UINode root) {
-        _root = root;
+        _root = std::move(root);
+    }
+
+    const UINode& root() const {
+        return _root;
     }
 
     void layout(const Context& context);
@@ -104,7 +108,6 @@ class UI {
     void cleanup();
 
    private:
-    UINode _root;
     UINode::ID _nextNodeID{1};
 
     struct NodeRenderInfo {
@@ -120,6 +123,7 @@ class UI {
         UINode node;
         node.id = _nextNodeID++;
         node.element = element;
+        node.children.reserve(element.children.size());
         for (const UIElement& childElement : element.children) {
             node.children.push_back(createNodeFromElement(childElement, node.parentID));
         }
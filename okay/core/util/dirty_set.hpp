@@ -2,6 +2,7 @@
 #define __DIRTY_SET_H__
 
 #include <algorithm>
+#include <bit>
 #include <cstdint>
 #include <span>
 #include <vector>
@@ -91,6 +92,60 @@ class DirtySet final {
     std::vector<std::uint8_t> _present;
 };
 
+// one bit per index, for dirty state over dense ranges that is scanned in index order
+class DirtyBitset final {
+   public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    void resize(std::size_t size) {
+        _words.resize((size + 63) / 64, 0);
+        _size = size;
+    }
+
+    std::size_t size() const {
+        return _size;
+    }
+
+    void set(std::size_t i) {
+        _words[i / 64] |= 1ULL << (i % 64);
+    }
+
+    bool test(std::size_t i) const {
+        return (_words[i / 64] >> (i % 64)) & 1ULL;
+    }
+
+    void setAll() {
+        std::fill(_words.begin(), _words.end(), ~0ULL);
+        // keep the bits past size clear so findNext never returns them
+        if (_size % 64 != 0)
+            _words.back() = (1ULL << (_size % 64)) - 1ULL;
+    }
+
+    void clear() {
+        std::fill(_words.begin(), _words.end(), 0ULL);
+    }
+
+    // first set bit at or after from, npos if there is none
+    std::size_t findNext(std::size_t from) const {
+        if (from >= _size)
+            return npos;
+
+        std::size_t word = from / 64;
+        std::uint64_t bits = _words[word] & (~0ULL << (from % 64));
+        while (bits == 0) {
+            if (++word == _words.size())
+                return npos;
+            bits = _words[word];
+        }
+        std::size_t i = word * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+        return i < _size ? i : npos;
+    }
+
+   private:
+    std::vector<std::uint64_t> _words;
+    std::size_t _size{0};
+};
+
 }  // namespace okay
 
 #endif  // __DIRTY_SET_H__
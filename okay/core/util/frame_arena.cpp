@@ -0,0 +1,76 @@
+#include <okay/core/util/frame_arena.hpp>
+
+#include <algorithm>
+
+using namespace okay;
+
+FrameArena::FrameArena(std::size_t blockSize)
+    : _block(std::make_unique<std::byte[]>(blockSize)), _capacity(blockSize) {}
+
+FrameArena::~FrameArena() = default;
+
+FrameArena& FrameArena::local() {
+    thread_local FrameArena s_arena;
+
+    std::uint64_t epoch = s_frameEpoch.load(std::memory_order_relaxed);
+    if (s_arena._epoch != epoch) {
+        s_arena.reset();
+        s_arena._epoch = epoch;
+    }
+
+    return s_arena;
+}
+
+void FrameArena::reset() {
+    if (!_overflow.empty()) {
+        // grow so that a frame like the last one fits in a single block
+        _capacity += _overflowBytes;
+        _block = std::make_unique<std::byte[]>(_capacity);
+        _overflow.clear();
+        _overflowCapacity = 0;
+        _overflowOffset = 0;
+        _overflowBytes = 0;
+        _overflowUsed = 0;
+    }
+
+    _offset = 0;
+}
+
+void* FrameArena::bump(std::byte* block,
+    std::size_t capacity,
+    std::size_t& offset,
+    std::size_t bytes,
+    std::size_t alignment) {
+    std::uintptr_t base = reinterpret_cast<std::uintptr_t>(block);
+    std::uintptr_t aligned = (base + offset + alignment - 1) & ~(alignment - 1);
+
+    if (aligned + bytes > base + capacity)
+        return nullptr;
+
+    offset = aligned + bytes - base;
+    return reinterpret_cast<void*>(aligned);
+}
+
+void* FrameArena::do_allocate(std::size_t bytes, std::size_t alignment) {
+    if (_overflow.empty()) {
+        if (void* p = bump(_block.get(), _capacity, _offset, bytes, alignment))
+            return p;
+    } else {
+        std::size_t before = _overflowOffset;
+        if (void* p = bump(
+                _overflow.back().get(), _overflowCapacity, _overflowOffset, bytes, alignment)) {
+            _overflowUsed += _overflowOffset - before;
+            return p;
+        }
+    }
+
+    // out of room, continue in a new block until the next reset
+    _overflowCapacity = std::max(_capacity, bytes + alignment);
+    _overflowOffset = 0;
+    _overflow.push_back(std::make_unique<std::byte[]>(_overflowCapacity));
+    _overflowBytes += _overflowCapacity;
+
+    void* p = bump(_overflow.back().get(), _overflowCapacity, _overflowOffset, bytes, alignment);
+    _overflowUsed += _overflowOffset;
+    return p;
+}
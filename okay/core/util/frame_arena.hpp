@@ -0,0 +1,95 @@
+#ifndef __FRAME_ARENA_H__
+#define __FRAME_ARENA_H__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <memory_resource>
+#include <queue>
+#include <set>
+#include <vector>
+
+namespace okay {
+
+// Linear allocator for data that only lives until the end of the current frame.
+// Allocation is a pointer bump, deallocation is a no-op and reset() rewinds the whole arena.
+// Blocks that overflowed during a frame are folded into a single larger block on reset, so
+// in steady state every frame is served from one block without touching malloc.
+class FrameArena : public std::pmr::memory_resource {
+   public:
+    static constexpr std::size_t DEFAULT_BLOCK_SIZE = 256 * 1024;
+
+    explicit FrameArena(std::size_t blockSize = DEFAULT_BLOCK_SIZE);
+    ~FrameArena() override;
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // arena of the calling thread. it is reset lazily the first time it's used in a new frame
+    static FrameArena& local();
+
+    // ends the frame for the arenas of every thread, called by the engine once per frame
+    static void endFrame() {
+        s_frameEpoch.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void reset();
+
+    std::size_t bytesUsed() const {
+        return _offset + _overflowUsed;
+    }
+
+    std::size_t capacity() const {
+        return _capacity;
+    }
+
+   protected:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+
+    void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+   private:
+    std::unique_ptr<std::byte[]> _block;
+    std::size_t _capacity{0};
+    std::size_t _offset{0};
+
+    // blocks allocated once _block ran out this frame, only the last one is bumped into
+    std::vector<std::unique_ptr<std::byte[]>> _overflow;
+    std::size_t _overflowCapacity{0};
+    std::size_t _overflowOffset{0};
+    std::size_t _overflowBytes{0};
+    std::size_t _overflowUsed{0};
+
+    static void* bump(std::byte* block,
+        std::size_t capacity,
+        std::size_t& offset,
+        std::size_t bytes,
+        std::size_t alignment);
+
+    std::uint64_t _epoch{0};
+
+    inline static std::atomic<std::uint64_t> s_frameEpoch{0};
+};
+
+template <typename T>
+using FrameVector = std::pmr::vector<T>;
+
+template <typename T>
+using FrameQueue = std::queue<T, std::pmr::deque<T>>;
+
+template <typename T>
+using FrameSet = std::pmr::set<T>;
+
+inline std::pmr::polymorphic_allocator<std::byte> frameAllocator() {
+    return std::pmr::polymorphic_allocator<std::byte>(&FrameArena::local());
+}
+
+}  // namespace okay
+
+#endif  // __FRAME_ARENA_H__
@@ -0,0 +1,60 @@
+#ifndef __RADIX_SORT_H__
+#define __RADIX_SORT_H__
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <utility>
+
+namespace okay {
+
+// Stable LSD radix sort of items by a 64 bit key, one byte per pass. Bytes that are the same
+// for every key are skipped, so keys that only use a few bits cost a few passes. scratch must
+// be at least as large as items, the result always ends up in items.
+template <typename T, typename KeyFn>
+void radixSort(std::span<T> items, std::span<T> scratch, KeyFn&& key) {
+    constexpr std::size_t PASSES = sizeof(std::uint64_t);
+    const std::size_t n = items.size();
+    if (n < 2)
+        return;
+
+    // histogram every byte in a single read of the keys
+    std::array<std::array<std::uint32_t, 256>, PASSES> counts{};
+    for (const T& item : items) {
+        std::uint64_t k = key(item);
+        for (std::size_t pass = 0; pass < PASSES; ++pass) {
+            ++counts[pass][(k >> (pass * 8)) & 0xFFULL];
+        }
+    }
+
+    T* src = items.data();
+    T* dst = scratch.data();
+    for (std::size_t pass = 0; pass < PASSES; ++pass) {
+        std::array<std::uint32_t, 256>& count = counts[pass];
+        std::uint64_t firstByte = (key(src[0]) >> (pass * 8)) & 0xFFULL;
+        if (count[firstByte] == n)
+            continue;
+
+        std::uint32_t offset = 0;
+        for (std::uint32_t& c : count) {
+            std::uint32_t bucket = c;
+            c = offset;
+            offset += bucket;
+        }
+
+        for (std::size_t i = 0; i < n; ++i) {
+            dst[count[(key(src[i]) >> (pass * 8)) & 0xFFULL]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != items.data()) {
+        for (std::size_t i = 0; i < n; ++i) {
+            items[i] = src[i];
+        }
+    }
+}
+
+}  // namespace okay
+
+#endif  // __RADIX_SORT_H__
@@ -3,6 +3,8 @@
 
 #include <string_view>
 #include <tuple>
+#include <type_traits>
+#include <utility>
 
 namespace okay {
 struct NoneType {};
@@ -38,6 +40,19 @@ static void tupleForEach(Tuple&& t, Fn&& fn) {
     tupleForEachImpl(std::forward<Tuple>(t), std::forward<Fn>(fn), std::make_index_sequence<N>{});
 }
 
+// same as above, fn also gets the element's index as a std::integral_constant
+template <class Tuple, class Fn, std::size_t... I>
+static void tupleForEachIndexedImpl(Tuple&& t, Fn&& fn, std::index_sequence<I...>) {
+    (fn(std::get<I>(t), std::integral_constant<std::size_t, I>{}), ...);
+}
+
+template <class Tuple, class Fn>
+static void tupleForEachIndexed(Tuple&& t, Fn&& fn) {
+    constexpr std::size_t N = std::tuple_size_v<std::remove_reference_t<Tuple>>;
+    tupleForEachIndexedImpl(
+        std::forward<Tuple>(t), std::forward<Fn>(fn), std::make_index_sequence<N>{});
+}
+
 };  // namespace okay
 
 #endif  // __TYPE_H__
\ No newline at end of file
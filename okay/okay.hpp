@@ -41,18 +41,30 @@
 // okay/core/engine
 #include <okay/core/engine/engine.hpp>
 #include <okay/core/engine/event.hpp>
+#include <okay/core/engine/job_system.hpp>
 #include <okay/core/engine/logger.hpp>
+#include <okay/core/engine/memory_tracker.hpp>
+#include <okay/core/engine/replay.hpp>
+#include <okay/core/engine/stats.hpp>
 #include <okay/core/engine/system.hpp>
 #include <okay/core/engine/time.hpp>
 
 // okay/core/renderer
+#include <okay/core/renderer/aabb_tree.hpp>
+#include <okay/core/renderer/command_buffer.hpp>
+#include <okay/core/renderer/command_executor.hpp>
+#include <okay/core/renderer/culling.hpp>
+#include <okay/core/renderer/frame_uniforms.hpp>
 #include <okay/core/renderer/gl.hpp>
+#include <okay/core/renderer/gl_state.hpp>
 #include <okay/core/renderer/gpu.hpp>
 #include <okay/core/renderer/imgui_impl.hpp>
+#include <okay/core/renderer/instance_buffer.hpp>
 #include <okay/core/renderer/material.hpp>
 #include <okay/core/renderer/math_types.hpp>
 #include <okay/core/renderer/mesh.hpp>
 #include <okay/core/renderer/primitive.hpp>
+#include <okay/core/renderer/program_cache.hpp>
 #include <okay/core/renderer/render_pipeline.hpp>
 #include <okay/core/renderer/render_target.hpp>
 #include <okay/core/renderer/render_world.hpp>
@@ -93,9 +105,11 @@
 // okay/core/util
 #include <okay/core/util/dirty_set.hpp>
 #include <okay/core/util/format.hpp>
+#include <okay/core/util/frame_arena.hpp>
 #include <okay/core/util/object_pool.hpp>
 #include <okay/core/util/option.hpp>
 #include <okay/core/util/property.hpp>
+#include <okay/core/util/radix_sort.hpp>
 #include <okay/core/util/result.hpp>
 #include <okay/core/util/singleton.hpp>
 #include <okay/core/util/string.hpp>
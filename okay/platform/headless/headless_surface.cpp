@@ -0,0 +1,260 @@
+#include <okay/core/renderer/surface.hpp>
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <atomic>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+#ifndef EGL_PLATFORM_SURFACELESS_MESA
+#define EGL_PLATFORM_SURFACELESS_MESA 0x31DD
+#endif
+
+namespace {
+
+std::atomic<bool> g_quit{false};
+
+void sigint_handler(int) {
+    g_quit.store(true);
+}
+
+bool has_extension(const char* extensions, const char* name) {
+    if (!extensions)
+        return false;
+
+    const std::size_t len = std::strlen(name);
+    for (const char* p = std::strstr(extensions, name); p; p = std::strstr(p + len, name)) {
+        // make sure we matched a whole token, not a prefix of a longer one
+        bool startOk = p == extensions || p[-1] == ' ';
+        bool endOk = p[len] == ' ' || p[len] == '\0';
+        if (startOk && endOk)
+            return true;
+    }
+
+    return false;
+}
+
+EGLDisplay get_display() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+
+    auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+        eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+    if (getPlatformDisplay && has_extension(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        EGLDisplay dpy =
+            getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+        if (dpy != EGL_NO_DISPLAY)
+            return dpy;
+    }
+
+    return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+}
+
+EGLConfig choose_config(EGLDisplay dpy) {
+    const EGLint attribs[] = {EGL_SURFACE_TYPE,
+        EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE,
+        EGL_OPENGL_ES3_BIT,
+        EGL_RED_SIZE,
+        8,
+        EGL_GREEN_SIZE,
+        8,
+        EGL_BLUE_SIZE,
+        8,
+        EGL_ALPHA_SIZE,
+        8,
+        EGL_NONE};
+
+    EGLConfig config = nullptr;
+    EGLint numConfigs = 0;
+    if (eglChooseConfig(dpy, attribs, &config, 1, &numConfigs) && numConfigs > 0) {
+        return config;
+    }
+
+    return nullptr;
+}
+
+std::uint32_t frames_from_environment(std::uint32_t fallback) {
+    // lets CI pick the run length without rebuilding the game
+    if (const char* env = std::getenv("OKAY_HEADLESS_FRAMES")) {
+        return static_cast<std::uint32_t>(std::strtoul(env, nullptr, 10));
+    }
+    return fallback;
+}
+
+}  // namespace
+
+namespace okay {
+
+struct Surface::SurfaceImpl {
+    SurfaceConfig cfg;
+
+    EGLDisplay dpy = EGL_NO_DISPLAY;
+    EGLConfig cfgEGL = nullptr;
+    EGLContext ctx = EGL_NO_CONTEXT;
+    // only created when the driver doesn't support surfaceless contexts
+    EGLSurface pbuffer = EGL_NO_SURFACE;
+
+    // offscreen render target standing in for the default framebuffer
+    GLuint fbo = 0;
+    GLuint colorRb = 0;
+    GLuint depthRb = 0;
+
+    std::uint32_t maxFrames = 0;
+    std::uint32_t framesPresented = 0;
+
+    explicit SurfaceImpl(const SurfaceConfig& c) : cfg(c) {}
+};
+
+Surface::Surface(const SurfaceConfig& cfg) : _impl(std::make_unique<SurfaceImpl>(cfg)) {}
+
+Surface::~Surface() = default;
+
+Surface::Surface(Surface&&) noexcept = default;
+Surface& Surface::operator=(Surface&&) noexcept = default;
+
+void* Surface::getWindow() {
+    return nullptr;
+}
+
+void* Surface::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+void Surface::initialize() {
+    std::signal(SIGINT, sigint_handler);
+
+    _impl->maxFrames = frames_from_environment(_impl->cfg.maxFrames);
+
+    _impl->dpy = get_display();
+    if (_impl->dpy == EGL_NO_DISPLAY) {
+        throw std::runtime_error("eglGetDisplay failed");
+    }
+
+    if (!eglInitialize(_impl->dpy, nullptr, nullptr)) {
+        throw std::runtime_error("eglInitialize failed");
+    }
+
+    if (!eglBindAPI(EGL_OPENGL_ES_API)) {
+        throw std::runtime_error("eglBindAPI(EGL_OPENGL_ES_API) failed");
+    }
+
+    _impl->cfgEGL = choose_config(_impl->dpy);
+    if (!_impl->cfgEGL) {
+        throw std::runtime_error("eglChooseConfig failed to find a GLES3 pbuffer config");
+    }
+
+    const EGLint ctxAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 3, EGL_NONE};
+    _impl->ctx = eglCreateContext(_impl->dpy, _impl->cfgEGL, EGL_NO_CONTEXT, ctxAttribs);
+    if (_impl->ctx == EGL_NO_CONTEXT) {
+        throw std::runtime_error("eglCreateContext failed");
+    }
+
+    const char* displayExtensions = eglQueryString(_impl->dpy, EGL_EXTENSIONS);
+    if (!has_extension(displayExtensions, "EGL_KHR_surfaceless_context")) {
+        const EGLint pbufferAttribs[] = {
+            EGL_WIDTH, _impl->cfg.width, EGL_HEIGHT, _impl->cfg.height, EGL_NONE};
+        _impl->pbuffer = eglCreatePbufferSurface(_impl->dpy, _impl->cfgEGL, pbufferAttribs);
+        if (_impl->pbuffer == EGL_NO_SURFACE) {
+            throw std::runtime_error("eglCreatePbufferSurface failed");
+        }
+    }
+
+    if (!eglMakeCurrent(_impl->dpy, _impl->pbuffer, _impl->pbuffer, _impl->ctx)) {
+        throw std::runtime_error("eglMakeCurrent failed");
+    }
+
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(eglGetProcAddress))) {
+        std::cout << "Failed to initialize GLAD for GLES" << std::endl;
+    }
+
+    const GLsizei w = static_cast<GLsizei>(_impl->cfg.width);
+    const GLsizei h = static_cast<GLsizei>(_impl->cfg.height);
+
+    glGenRenderbuffers(1, &_impl->colorRb);
+    glBindRenderbuffer(GL_RENDERBUFFER, _impl->colorRb);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, w, h);
+
+    glGenRenderbuffers(1, &_impl->depthRb);
+    glBindRenderbuffer(GL_RENDERBUFFER, _impl->depthRb);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, w, h);
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &_impl->fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, _impl->fbo);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _impl->colorRb);
+    glFramebufferRenderbuffer(
+        GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, _impl->depthRb);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("headless framebuffer is incomplete");
+    }
+
+    // the FBO stays bound for the lifetime of the surface, passes render into it as if it
+    // were the default framebuffer
+    glViewport(0, 0, w, h);
+}
+
+bool Surface::shouldClose() const {
+    if (g_quit.load())
+        return true;
+    return _impl->maxFrames != 0 && _impl->framesPresented >= _impl->maxFrames;
+}
+
+void Surface::pollEvents() {
+    // no-op
+}
+
+void Surface::swapBuffers() {
+    // nothing to present, just count the frame
+    _impl->framesPresented++;
+}
+
+void Surface::destroy() {
+    if (!_impl) {
+        return;
+    }
+
+    if (_impl->dpy == EGL_NO_DISPLAY) {
+        return;
+    }
+
+    if (_impl->ctx != EGL_NO_CONTEXT) {
+        if (_impl->fbo) {
+            glBindFramebuffer(GL_FRAMEBUFFER, 0);
+            glDeleteFramebuffers(1, &_impl->fbo);
+            _impl->fbo = 0;
+        }
+
+        if (_impl->colorRb) {
+            glDeleteRenderbuffers(1, &_impl->colorRb);
+            _impl->colorRb = 0;
+        }
+
+        if (_impl->depthRb) {
+            glDeleteRenderbuffers(1, &_impl->depthRb);
+            _impl->depthRb = 0;
+        }
+    }
+
+    eglMakeCurrent(_impl->dpy, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (_impl->pbuffer != EGL_NO_SURFACE) {
+        eglDestroySurface(_impl->dpy, _impl->pbuffer);
+        _impl->pbuffer = EGL_NO_SURFACE;
+    }
+
+    if (_impl->ctx != EGL_NO_CONTEXT) {
+        eglDestroyContext(_impl->dpy, _impl->ctx);
+        _impl->ctx = EGL_NO_CONTEXT;
+    }
+
+    eglTerminate(_impl->dpy);
+    _impl->dpy = EGL_NO_DISPLAY;
+}
+
+}  // namespace okay
@@ -0,0 +1,27 @@
+#include <okay/core/renderer/imgui_impl.hpp>
+
+#include <imgui.h>
+
+namespace okay {
+
+struct IMGUIImpl::Context {
+    // no window to draw into
+};
+
+bool IMGUIImpl::imguiSupported() {
+    return false;
+}
+
+IMGUIImpl::IMGUIImpl() : _context(std::make_unique<IMGUIImpl::Context>()) {}
+
+IMGUIImpl::~IMGUIImpl() {}
+
+void IMGUIImpl::init(void* window, bool enableCallbacks) {}
+
+void IMGUIImpl::newFrame() {}
+
+void IMGUIImpl::renderDrawData(ImDrawData* drawData) {}
+
+void IMGUIImpl::shutdown() {}
+
+};  // namespace okay
\ No newline at end of file
@@ -197,6 +197,10 @@ void* Surface::getWindow() {
     return _impl->gbmSurf;
 }
 
+void* Surface::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
 void Surface::initialize() {
     std::signal(SIGINT, sigint_handler);
 
@@ -44,6 +44,10 @@ void* Surface::getWindow() {
     return _impl->window;
 }
 
+void* Surface::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(glfwGetProcAddress(name));
+}
+
 bool Surface::shouldClose() const {
     return _impl->window ? glfwWindowShouldClose(_impl->window) : true;
 }
@@ -0,0 +1,248 @@
+#include "bench_report.hpp"
+
+#include <okay/core/engine/engine.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <sstream>
+#include <string_view>
+
+#if defined(__GNUG__)
+#include <cxxabi.h>
+#endif
+
+namespace bench {
+
+namespace {
+
+constexpr std::string_view SYSTEM_STAT_PREFIX = "system.";
+
+std::string demangle(std::string_view name) {
+#if defined(__GNUG__)
+    int status = 0;
+    std::string mangled(name);
+    char* demangled = abi::__cxa_demangle(mangled.c_str(), nullptr, nullptr, &status);
+    if (status == 0 && demangled != nullptr) {
+        std::string result(demangled);
+        std::free(demangled);
+        return result;
+    }
+#endif
+    return std::string(name);
+}
+
+std::string escape(std::string_view text) {
+    std::string out;
+    out.reserve(text.size());
+    for (char c : text) {
+        if (c == '"' || c == '\\')
+            out += '\\';
+        out += c;
+    }
+    return out;
+}
+
+double mean(const std::vector<double>& values) {
+    if (values.empty())
+        return 0.0;
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+// linear interpolation between the closest ranks, sorted must be sorted
+double percentile(const std::vector<double>& sorted, double p) {
+    if (sorted.empty())
+        return 0.0;
+
+    double rank = p / 100.0 * static_cast<double>(sorted.size() - 1);
+    std::size_t lower = static_cast<std::size_t>(rank);
+    std::size_t upper = std::min(lower + 1, sorted.size() - 1);
+    double t = rank - static_cast<double>(lower);
+    return sorted[lower] + (sorted[upper] - sorted[lower]) * t;
+}
+
+struct MetricWriter {
+    std::string out;
+    bool first{true};
+
+    void add(std::string_view key, double value) {
+        out += first ? "\n" : ",\n";
+        out += std::format("    \"{}\": {:.4f}", escape(key), value);
+        first = false;
+    }
+
+    void addDistribution(std::string_view key, std::vector<double> values) {
+        std::sort(values.begin(), values.end());
+        add(std::format("{}.mean", key), mean(values));
+        add(std::format("{}.p50", key), percentile(values, 50.0));
+        add(std::format("{}.p90", key), percentile(values, 90.0));
+        add(std::format("{}.p99", key), percentile(values, 99.0));
+        add(std::format("{}.max", key), values.empty() ? 0.0 : values.back());
+    }
+};
+
+bool lowerIsBetter(std::string_view key) {
+    return key.starts_with("frame_ms.") || key.starts_with("system_us.") ||
+           key.starts_with("allocations.");
+}
+
+// reads the flat "metrics" object written by BenchRecorder::toJson, not a general json parser
+bool readMetrics(const std::filesystem::path& path, std::map<std::string, double>& metrics) {
+    std::ifstream in(path);
+    if (!in.is_open()) {
+        std::cerr << "Unable to open " << path.string() << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << in.rdbuf();
+    std::string json = buffer.str();
+
+    std::size_t pos = json.find("\"metrics\"");
+    if (pos == std::string::npos || (pos = json.find('{', pos)) == std::string::npos) {
+        std::cerr << "No metrics object in " << path.string() << std::endl;
+        return false;
+    }
+
+    ++pos;
+    while (pos < json.size()) {
+        pos = json.find_first_of("\"}", pos);
+        if (pos == std::string::npos || json[pos] == '}')
+            break;
+
+        std::string key;
+        for (++pos; pos < json.size() && json[pos] != '"'; ++pos) {
+            if (json[pos] == '\\')
+                ++pos;
+            key += json[pos];
+        }
+
+        pos = json.find(':', pos);
+        if (pos == std::string::npos)
+            break;
+
+        char* end = nullptr;
+        metrics[key] = std::strtod(json.c_str() + pos + 1, &end);
+        pos = static_cast<std::size_t>(end - json.c_str());
+    }
+
+    return true;
+}
+
+}  // namespace
+
+BenchRecorder::BenchRecorder(std::string scene, std::size_t warmupFrames, std::size_t frames)
+    : _scene(std::move(scene)), _warmupFrames(warmupFrames), _frames(frames) {
+    _frameMs.reserve(frames);
+    _allocations.reserve(frames);
+    _allocatedBytes.reserve(frames);
+}
+
+void BenchRecorder::sampleFrame(double frameMs) {
+    _frameMs.push_back(frameMs);
+
+    const okay::FrameStats& stats = okay::Engine.stats;
+    for (okay::FrameStats::StatId id = 0; id < stats.count(); ++id) {
+        std::vector<double>& samples = _stats[std::string(stats.name(id))];
+        if (samples.empty())
+            samples.reserve(_frames);
+        samples.push_back(static_cast<double>(stats.last(id)));
+    }
+
+    if constexpr (okay::MemoryTracker::enabled()) {
+        okay::MemoryReport report = okay::MemoryTracker::report();
+        _allocations.push_back(static_cast<double>(report.lastFrameAllocations));
+        _allocatedBytes.push_back(static_cast<double>(report.lastFrameBytes));
+    }
+}
+
+std::string BenchRecorder::toJson() const {
+    MetricWriter metrics;
+    metrics.addDistribution("frame_ms", _frameMs);
+
+    for (const auto& [name, samples] : _stats) {
+        if (name.starts_with(SYSTEM_STAT_PREFIX)) {
+            std::string system = demangle(std::string_view(name).substr(SYSTEM_STAT_PREFIX.size()));
+            metrics.addDistribution(std::format("system_us.{}", system), samples);
+        } else {
+            metrics.add(std::format("stats.{}.mean", name), mean(samples));
+            metrics.add(std::format("stats.{}.max", name),
+                samples.empty() ? 0.0 : *std::max_element(samples.begin(), samples.end()));
+        }
+    }
+
+    if constexpr (okay::MemoryTracker::enabled()) {
+        metrics.addDistribution("allocations.count", _allocations);
+        metrics.addDistribution("allocations.bytes", _allocatedBytes);
+    }
+
+    return std::format(
+        "{{\n"
+        "  \"scene\": \"{}\",\n"
+        "  \"warmup_frames\": {},\n"
+        "  \"frames\": {},\n"
+        "  \"allocation_tracking\": {},\n"
+        "  \"metrics\": {{{}\n"
+        "  }}\n"
+        "}}\n",
+        escape(_scene),
+        _warmupFrames,
+        _frameMs.size(),
+        okay::MemoryTracker::enabled() ? "true" : "false",
+        metrics.out);
+}
+
+std::size_t compareResults(const std::filesystem::path& baseline,
+    const std::filesystem::path& results,
+    double thresholdPercent) {
+    std::map<std::string, double> before;
+    std::map<std::string, double> after;
+    if (!readMetrics(baseline, before) || !readMetrics(results, after))
+        return 1;
+
+    std::size_t regressions = 0;
+    std::cout << std::format(
+        "{:<60} {:>14} {:>14} {:>9}\n", "metric", "baseline", "result", "change");
+
+    for (const auto& [key, value] : after) {
+        auto it = before.find(key);
+        if (it == before.end()) {
+            std::cout << std::format("{:<60} {:>14} {:>14.4f} {:>9}\n", key, "-", value, "new");
+            continue;
+        }
+
+        double base = it->second;
+        double change = 0.0;
+        if (base != 0.0)
+            change = (value - base) / base * 100.0;
+        else if (value > 0.0)
+            // going from nothing to something is an unbounded increase, e.g. new per frame
+            // allocations
+            change = std::numeric_limits<double>::infinity();
+        bool regressed = lowerIsBetter(key) && change > thresholdPercent;
+        regressions += regressed;
+
+        std::cout << std::format("{:<60} {:>14.4f} {:>14.4f} {:>+8.1f}%{}\n",
+            key,
+            base,
+            value,
+            change,
+            regressed ? "  REGRESSED" : "");
+    }
+
+    for (const auto& [key, value] : before) {
+        if (!after.contains(key)) {
+            std::cout << std::format("{:<60} {:>14.4f} {:>14} {:>9}\n", key, value, "-", "removed");
+        }
+    }
+
+    std::cout << std::format(
+        "\n{} metric(s) regressed by more than {}%\n", regressions, thresholdPercent);
+    return regressions;
+}
+
+}  // namespace bench
@@ -0,0 +1,53 @@
+#ifndef __BENCH_REPORT_H__
+#define __BENCH_REPORT_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+// per-frame samples of one measured scene run
+class BenchRecorder {
+   public:
+    BenchRecorder(std::string scene, std::size_t warmupFrames, std::size_t frames);
+
+    // called once per measured frame, pulls the last completed frame's engine stats
+    void sampleFrame(double frameMs);
+
+    std::size_t sampledFrames() const {
+        return _frameMs.size();
+    }
+
+    bool done() const {
+        return _frameMs.size() >= _frames;
+    }
+
+    // flat "metrics" object keyed by "<group>.<name>.<aggregate>", which is what --compare
+    // diffs. lower is better for frame_ms, system_us and allocations
+    std::string toJson() const;
+
+   private:
+    std::string _scene;
+    std::size_t _warmupFrames;
+    std::size_t _frames;
+
+    std::vector<double> _frameMs;
+    // engine stat name -> one value per sampled frame
+    std::map<std::string, std::vector<double>> _stats;
+    std::vector<double> _allocations;
+    std::vector<double> _allocatedBytes;
+};
+
+// diffs every metric in results against baseline, prints a table and returns the number of
+// metrics that regressed by more than thresholdPercent (1 if either file can't be read)
+std::size_t compareResults(const std::filesystem::path& baseline,
+    const std::filesystem::path& results,
+    double thresholdPercent);
+
+}  // namespace bench
+
+#endif  // __BENCH_REPORT_H__
@@ -0,0 +1,165 @@
+#include "bench_report.hpp"
+#include "scenes.hpp"
+
+#include <okay/okay.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+
+// okay_bench, runs one stress scene for a fixed number of frames and writes json results.
+//
+//   bench <scene> [--frames N] [--warmup N] [--out results.json]
+//   bench --list
+//   bench --compare baseline.json results.json [--threshold percent]
+//
+// The okay cli doesn't forward arguments, so the run options can also be given through
+// OKAY_BENCH_SCENE, OKAY_BENCH_FRAMES, OKAY_BENCH_WARMUP and OKAY_BENCH_OUT. Build with
+// -DOKAY_PLATFORM=headless for runs that don't depend on a display, and with
+// -DOKAY_TRACK_ALLOCATIONS=ON to get allocation counts.
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct BenchOptions {
+    std::string scene;
+    std::size_t frames{600};
+    std::size_t warmup{120};
+    std::string out;
+};
+
+const bench::BenchScene* s_scene = nullptr;
+std::optional<bench::BenchRecorder> s_recorder;
+BenchOptions s_options;
+Clock::time_point s_lastUpdate;
+
+std::string envOr(const char* name, std::string fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::string(value) : fallback;
+}
+
+void listScenes() {
+    for (const bench::BenchScene& scene : bench::scenes()) {
+        std::cout << scene.name << "\t" << scene.description << std::endl;
+    }
+}
+
+void benchInitialize() {
+    okay::MemoryTracker::setWarmupFrames(s_options.warmup);
+    s_scene->setup();
+    s_lastUpdate = Clock::now();
+}
+
+void benchUpdate() {
+    std::size_t frame = okay::Engine.frameCount();
+    s_scene->update(frame);
+
+    // onUpdate runs once per frame, so the time between calls is a whole frame
+    Clock::time_point now = Clock::now();
+    double frameMs = std::chrono::duration<double, std::milli>(now - s_lastUpdate).count();
+    s_lastUpdate = now;
+
+    if (frame < s_options.warmup)
+        return;
+
+    s_recorder->sampleFrame(frameMs);
+    if (s_recorder->done()) {
+        okay::Engine.shutdown();
+    }
+}
+
+void benchShutdown() {
+    std::string json = s_recorder->toJson();
+
+    if (s_options.out.empty()) {
+        std::cout << json;
+        return;
+    }
+
+    std::ofstream out(s_options.out);
+    out << json;
+    okay::Engine.logger.info("Wrote {} frames of {} to {}",
+        s_recorder->sampledFrames(),
+        s_options.scene,
+        s_options.out);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    s_options.scene = envOr("OKAY_BENCH_SCENE", "");
+    s_options.frames = std::stoul(envOr("OKAY_BENCH_FRAMES", std::to_string(s_options.frames)));
+    s_options.warmup = std::stoul(envOr("OKAY_BENCH_WARMUP", std::to_string(s_options.warmup)));
+    s_options.out = envOr("OKAY_BENCH_OUT", "");
+
+    std::string baseline;
+    std::string results;
+    double threshold = 5.0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--list") {
+            listScenes();
+            return 0;
+        } else if (arg == "--frames" && hasValue) {
+            s_options.frames = std::stoul(argv[++i]);
+        } else if (arg == "--warmup" && hasValue) {
+            s_options.warmup = std::stoul(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            s_options.out = argv[++i];
+        } else if (arg == "--threshold" && hasValue) {
+            threshold = std::stod(argv[++i]);
+        } else if (arg == "--compare" && i + 2 < argc) {
+            baseline = argv[++i];
+            results = argv[++i];
+        } else {
+            s_options.scene = arg;
+        }
+    }
+
+    if (!baseline.empty()) {
+        return bench::compareResults(baseline, results, threshold) == 0 ? 0 : 1;
+    }
+
+    s_scene = bench::findScene(s_options.scene);
+    if (s_scene == nullptr) {
+        std::cerr << "Unknown scene '" << s_options.scene << "', available scenes:" << std::endl;
+        listScenes();
+        return 1;
+    }
+
+    s_recorder.emplace(s_options.scene, s_options.warmup, s_options.frames);
+
+    okay::SurfaceConfig surfaceConfig;
+    surfaceConfig.width = 1280;
+    surfaceConfig.height = 720;
+    surfaceConfig.title = "okay bench";
+    // backstop in case the scene shuts down late, the recorder normally ends the run
+    surfaceConfig.maxFrames =
+        static_cast<std::uint32_t>(s_options.warmup + s_options.frames + 1);
+    okay::Surface surface(surfaceConfig);
+
+    okay::RendererSettings rendererSettings{.surfaceConfig = surfaceConfig,
+        .pipeline = okay::RenderPipeline::create(std::make_unique<okay::ScenePass>()),
+        .enableIMGUI = false};
+
+    auto renderer = okay::Renderer::create(std::move(rendererSettings));
+
+    okay::Game::create()
+        .addSystems(std::move(renderer),
+            std::make_unique<okay::AssetManager>(),
+            std::make_unique<okay::ECS>(),
+            std::make_unique<okay::TweenEngine>())
+        .onInitialize(benchInitialize)
+        .onUpdate(benchUpdate)
+        .onShutdown(benchShutdown)
+        .run();
+
+    return 0;
+}
@@ -0,0 +1,17 @@
+# This will be called from raxel's internal cmake
+# The objective of this file is to add the sources and includes to the project
+# Then, raxel will take care of linking the libraries and setting the flags
+
+set(SOURCES
+    ${OKAY_PROJECT_ROOT_DIR}/main.cpp
+    ${OKAY_PROJECT_ROOT_DIR}/scenes.cpp
+    ${OKAY_PROJECT_ROOT_DIR}/bench_report.cpp
+)
+
+set(INCLUDES
+    ${OKAY_PROJECT_ROOT_DIR}
+)
+
+# add the sources and includes to PROJECT executable
+target_sources(${PROJECT} PRIVATE ${SOURCES})
+target_include_directories(${PROJECT} PRIVATE ${INCLUDES})
@@ -0,0 +1,37 @@
+#!/usr/bin/env bash
+# runs every bench scene and, when a baseline directory is given, compares against it.
+# usage: run_bench.sh <bench executable> <results dir> [baseline dir] [threshold percent]
+#
+# the executable has to be run from its build directory so it finds the packaged assets
+
+set -euo pipefail
+
+if [ $# -lt 2 ]; then
+    echo "usage: $0 <bench executable> <results dir> [baseline dir] [threshold percent]"
+    exit 1
+fi
+
+BENCH="$(realpath "$1")"
+RESULTS="$(realpath -m "$2")"
+BASELINE="${3:-}"
+THRESHOLD="${4:-5}"
+
+mkdir -p "$RESULTS"
+cd "$(dirname "$BENCH")"
+
+regressed=0
+for scene in $("$BENCH" --list | cut -f1); do
+    echo "== $scene"
+    "$BENCH" "$scene" --out "$RESULTS/$scene.json"
+
+    if [ -n "$BASELINE" ]; then
+        if [ -f "$BASELINE/$scene.json" ]; then
+            "$BENCH" --compare "$BASELINE/$scene.json" "$RESULTS/$scene.json" \
+                --threshold "$THRESHOLD" || regressed=1
+        else
+            echo "no baseline for $scene, skipping comparison"
+        fi
+    fi
+done
+
+exit $regressed
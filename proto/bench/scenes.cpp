@@ -0,0 +1,231 @@
+#include "scenes.hpp"
+
+#include <okay/okay.hpp>
+
+#include <deque>
+#include <glm/glm.hpp>
+#include <random>
+
+namespace ui = okay::ui;
+
+namespace bench {
+
+namespace {
+
+// fixed seed, every run builds the exact same scene
+std::mt19937 s_rng{1234};
+
+glm::vec3 randomPosition(float radius) {
+    std::uniform_real_distribution<float> dist(-radius, radius);
+    return glm::vec3{dist(s_rng), dist(s_rng), dist(s_rng)};
+}
+
+struct SceneResources {
+    okay::Mesh cube{okay::Mesh::none()};
+    okay::MaterialHandle material{okay::MaterialHandle::none()};
+};
+
+SceneResources s_resources;
+
+void setupCommon(float cameraDistance) {
+    okay::ecs::registerBuiltins();
+
+    okay::Texture texture = okay::load::engineTexture("textures/uv_test.jpg");
+    okay::ShaderHandle shader = okay::shaderHandle(okay::load::engineShader("shaders/lit"));
+
+    auto materialProperties = std::make_unique<okay::LitMaterial>();
+    materialProperties->color.set(glm::vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    materialProperties->albedo = texture;
+
+    s_resources.cube = okay::mesh(okay::primitives::box().build());
+    s_resources.material = okay::materialHandle(shader, std::move(materialProperties));
+
+    okay::ecs::entity()
+        .addComponent<okay::TransformComponent>(glm::vec3{},
+            glm::vec3{0.1f},
+            glm::angleAxis(glm::radians(0.0f), glm::vec3{2.0f, 3.0f, 1.0f}))
+        .addComponent<okay::LightComponent>(
+            okay::LightComponent::directional(glm::vec3{1, 1, 1}, 2.5f));
+
+    okay::ECSEntity camera =
+        okay::ecs::entity()
+            .addComponent<okay::TransformComponent>(glm::vec3{0.0f, 0.0f, cameraDistance})
+            .addComponent<okay::CameraComponent>(
+                okay::CameraComponent{okay::Camera::PerspectiveLens{45.0f, 0.1f, 500.0f}});
+
+    camera.getComponent<okay::TransformComponent>().value().lookAt(camera, glm::vec3{});
+}
+
+okay::ECSEntity spawnCube(glm::vec3 position, float scale) {
+    return okay::ecs::entity()
+        .addComponent<okay::TransformComponent>(position, glm::vec3{scale})
+        .addComponent<okay::MeshRendererComponent>(s_resources.cube, s_resources.material);
+}
+
+okay::ECSEntity spawnChildCube(okay::ECSEntity& parent, glm::vec3 position, float scale) {
+    return okay::ecs::entity(parent)
+        .addComponent<okay::TransformComponent>(position, glm::vec3{scale})
+        .addComponent<okay::MeshRendererComponent>(s_resources.cube, s_resources.material);
+}
+
+// cubes: roots with CHILDREN children each, the roots spin so every level of the hierarchy
+// has to be re-propagated each frame
+constexpr std::size_t CHILDREN = 4;
+
+std::vector<okay::ECSEntity> s_roots;
+
+void setupCubes(std::size_t count) {
+    setupCommon(120.0f);
+
+    s_roots.reserve(count / (CHILDREN + 1));
+    for (std::size_t i = 0; i < count / (CHILDREN + 1); ++i) {
+        okay::ECSEntity root = spawnCube(randomPosition(60.0f), 0.5f);
+        for (std::size_t c = 0; c < CHILDREN; ++c) {
+            spawnChildCube(root, randomPosition(3.0f), 0.5f);
+        }
+        s_roots.push_back(root);
+    }
+}
+
+void updateCubes(std::size_t frame) {
+    // driven by the frame index instead of time so the workload doesn't depend on frame rate
+    float angle = static_cast<float>(frame) * 0.01f;
+    glm::quat rotation = glm::angleAxis(angle, glm::vec3{0.0f, 1.0f, 0.0f});
+
+    for (okay::ECSEntity& root : s_roots) {
+        auto& transform = root.getComponent<okay::TransformComponent>().value();
+        transform->rotation = rotation;
+    }
+}
+
+// ui: a grid of labels whose numbers change every frame, so every text mesh is rebuilt
+constexpr std::int32_t LABEL_COLUMNS = 10;
+constexpr std::int32_t LABEL_ROWS = 40;
+
+std::size_t s_uiFrame = 0;
+
+void setupLabels() {
+    setupCommon(5.0f);
+
+    okay::ecs::entity().addComponent<okay::TransformComponent>().addComponent<okay::UIComponent>(
+        []() {
+            return ui::flexbox()(ui::row()(ui::range(LABEL_COLUMNS, [](std::int32_t column) {
+                return ui::column()(ui::range(LABEL_ROWS, [column](std::int32_t row) {
+                    std::size_t value = (s_uiFrame + 1) * static_cast<std::size_t>(
+                                                              column * LABEL_ROWS + row + 1);
+                    return ui::text(std::format("{}", value % 100000));
+                }));
+            })));
+        });
+}
+
+void updateLabels(std::size_t frame) {
+    s_uiFrame = frame;
+}
+
+// tweens: thousands of looping float tweens, a slice of them drive cube heights
+constexpr std::size_t TWEEN_COUNT = 5000;
+constexpr std::size_t TWEENED_CUBES = 500;
+
+std::vector<float> s_tweenValues;
+std::vector<okay::ECSEntity> s_tweenedCubes;
+
+void setupTweens() {
+    setupCommon(60.0f);
+
+    const okay::EasingFn easings[] = {okay::easing::linear,
+        okay::easing::sineInOut,
+        okay::easing::quadInOut,
+        okay::easing::cubicInOut,
+        okay::easing::expoInOut};
+
+    // tweens hold references into this, it must never reallocate
+    s_tweenValues.assign(TWEEN_COUNT, 0.0f);
+
+    for (std::size_t i = 0; i < TWEEN_COUNT; ++i) {
+        okay::TweenConfig<float> cfg{.start = -10.0f,
+            .end = 10.0f,
+            .ref = std::ref(s_tweenValues[i]),
+            .durationMs = static_cast<std::uint32_t>(500 + (i % 7) * 250),
+            .easingFn = easings[i % std::size(easings)],
+            .numLoops = -1,
+            .inOutBack = true};
+        okay::Tween<float>::create(cfg)->start();
+    }
+
+    s_tweenedCubes.reserve(TWEENED_CUBES);
+    for (std::size_t i = 0; i < TWEENED_CUBES; ++i) {
+        s_tweenedCubes.push_back(spawnCube(randomPosition(30.0f), 0.5f));
+    }
+}
+
+void updateTweens(std::size_t) {
+    for (std::size_t i = 0; i < s_tweenedCubes.size(); ++i) {
+        auto& transform = s_tweenedCubes[i].getComponent<okay::TransformComponent>().value();
+        transform->position.y = s_tweenValues[i];
+    }
+}
+
+// churn: a fixed population where a slice is destroyed and respawned every frame
+constexpr std::size_t CHURN_POPULATION = 5000;
+constexpr std::size_t CHURN_PER_FRAME = 250;
+
+std::deque<okay::ECSEntity> s_churned;
+
+void spawnChurned() {
+    okay::ECSEntity root = spawnCube(randomPosition(60.0f), 0.5f);
+    spawnChildCube(root, randomPosition(3.0f), 0.5f);
+    s_churned.push_back(root);
+}
+
+void setupChurn() {
+    setupCommon(120.0f);
+
+    for (std::size_t i = 0; i < CHURN_POPULATION; ++i) {
+        spawnChurned();
+    }
+}
+
+void updateChurn(std::size_t) {
+    for (std::size_t i = 0; i < CHURN_PER_FRAME; ++i) {
+        okay::ecs::destroyEntity(s_churned.front());
+        s_churned.pop_front();
+        spawnChurned();
+    }
+}
+
+}  // namespace
+
+const std::vector<BenchScene>& scenes() {
+    static const std::vector<BenchScene> s_scenes = {
+        {"cubes_10k",
+            "10k lit cubes, spinning roots with 4 children each",
+            []() { setupCubes(10000); },
+            updateCubes},
+        {"cubes_50k",
+            "50k lit cubes, spinning roots with 4 children each",
+            []() { setupCubes(50000); },
+            updateCubes},
+        {"ui_labels",
+            "400 text labels whose numbers change every frame",
+            setupLabels,
+            updateLabels},
+        {"tweens", "5k looping tweens driving 500 cubes", setupTweens, updateTweens},
+        {"churn",
+            "5k cube pairs, 250 destroyed and respawned every frame",
+            setupChurn,
+            updateChurn},
+    };
+
+    return s_scenes;
+}
+
+const BenchScene* findScene(std::string_view name) {
+    for (const BenchScene& scene : scenes()) {
+        if (scene.name == name)
+            return &scene;
+    }
+    return nullptr;
+}
+
+}  // namespace bench
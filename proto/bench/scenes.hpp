@@ -0,0 +1,26 @@
+#ifndef __BENCH_SCENES_H__
+#define __BENCH_SCENES_H__
+
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+namespace bench {
+
+struct BenchScene {
+    std::string_view name;
+    std::string_view description;
+    // called from onInitialize, builds the scene
+    std::function<void()> setup;
+    // called from onUpdate every frame, including warmup frames
+    std::function<void(std::size_t frame)> update;
+};
+
+const std::vector<BenchScene>& scenes();
+
+const BenchScene* findScene(std::string_view name);
+
+}  // namespace bench
+
+#endif  // __BENCH_SCENES_H__
@@ -87,7 +87,7 @@ static void __gameInitialize() {
 
     okay::ecs::entity().addComponent<okay::TransformComponent>().addComponent<okay::UIComponent>(
         []() {
-            return ui::frame(10, 10, 200, 100)(ui::flexbox()
+            return ui::frame(10, 10, 200, 160)(ui::flexbox()
                     .marginSet(10)
                     .paddingSet(10)
                     .rightPaddingSet(20)
@@ -97,7 +97,12 @@ static void __gameInitialize() {
                     .borderWidthSet(1)(ui::h3("Performance"),
                         ui::vspacer(10),
                         ui::h3(std::format("FPS: {:2f}", okay::Engine.time->fps())),
-                        ui::h2(std::format("Entity count: {}", okay::ecs::entityCount()))));
+                        ui::h2(std::format("Entity count: {}", okay::ecs::entityCount())),
+                        ui::h2(std::format("Draw calls: {}",
+                            okay::Engine.stats.last(okay::Stat::DRAW_CALLS))),
+                        ui::h2(std::format("Visible: {} Culled: {}",
+                            okay::Engine.stats.last(okay::Stat::VISIBLE_ITEMS),
+                            okay::Engine.stats.last(okay::Stat::CULLED_ITEMS)))));
         });
 }
 
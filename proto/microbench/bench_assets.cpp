@@ -0,0 +1,91 @@
+#include "microbench.hpp"
+
+#include <okay/core/asset/asset.hpp>
+#include <okay/core/asset/mesh/obj_loader.hpp>
+
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <memory>
+#include <sstream>
+
+namespace microbench {
+
+namespace {
+
+// a size x size grid of quads with positions, uvs and normals, ~65k vertices at 256
+std::string makeGridObj(std::size_t size) {
+    std::string obj;
+    obj.reserve(size * size * 96);
+
+    for (std::size_t y = 0; y <= size; ++y) {
+        for (std::size_t x = 0; x <= size; ++x) {
+            float u = static_cast<float>(x) / static_cast<float>(size);
+            float v = static_cast<float>(y) / static_cast<float>(size);
+            obj += std::format("v {:.5f} 0.0 {:.5f}\n", u * 10.0f, v * 10.0f);
+            obj += std::format("vt {:.5f} {:.5f}\n", u, v);
+        }
+    }
+    obj += "vn 0.0 1.0 0.0\n";
+
+    std::size_t row = size + 1;
+    for (std::size_t y = 0; y < size; ++y) {
+        for (std::size_t x = 0; x < size; ++x) {
+            // obj indices are 1 based
+            std::size_t a = y * row + x + 1;
+            std::size_t b = a + 1;
+            std::size_t c = a + row + 1;
+            std::size_t d = a + row;
+            obj += std::format("f {0}/{0}/1 {1}/{1}/1 {2}/{2}/1 {3}/{3}/1\n", a, b, c, d);
+        }
+    }
+
+    return obj;
+}
+
+RunFn loadObjFn(std::filesystem::path path, std::string contents) {
+    struct LoadData {
+        std::filesystem::path path;
+        std::istringstream stream;
+        okay::ObjLoader loader;
+    };
+
+    auto data = std::make_shared<LoadData>();
+    data->path = std::move(path);
+    data->stream.str(std::move(contents));
+
+    return [data](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            data->stream.clear();
+            data->stream.seekg(0);
+            auto mesh = data->loader.Load(data->path, data->stream);
+            doNotOptimize(mesh);
+        }
+    };
+}
+
+}  // namespace
+
+void registerAssetBenchmarks(Suite& suite) {
+    // parsing only, the file is read into memory once during setup
+    for (std::size_t size : {64, 256}) {
+        suite.add(std::format("obj_loader/grid_{}x{}", size, size), [size]() -> RunFn {
+            return loadObjFn(std::format("grid_{}.obj", size), makeGridObj(size));
+        });
+    }
+
+    suite.add("obj_loader/teapot", []() -> RunFn {
+        std::filesystem::path path =
+            std::filesystem::path(OKAY_ENGINE_ASSET_ROOT) / "models" / "teapot.obj";
+
+        std::ifstream file(path);
+        if (!file.is_open())
+            return {};
+
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return loadObjFn(path, contents.str());
+    });
+}
+
+}  // namespace microbench
@@ -0,0 +1,228 @@
+#include "microbench.hpp"
+
+#include <okay/core/ecs/ecs.hpp>
+#include <okay/core/tween/tween_easing.hpp>
+#include <okay/core/util/object_pool.hpp>
+#include <okay/core/util/radix_sort.hpp>
+
+#include <algorithm>
+#include <format>
+#include <memory>
+#include <random>
+
+namespace microbench {
+
+namespace {
+
+struct Particle {
+    float position[3]{};
+    float velocity[3]{};
+    std::uint32_t flags{0};
+};
+
+struct Position {
+    float x{0.0f}, y{0.0f}, z{0.0f};
+};
+
+struct Velocity {
+    float x{1.0f}, y{0.0f}, z{0.0f};
+};
+
+// pool with `count` slots of which roughly `aliveFraction` are alive, spread uniformly
+std::shared_ptr<okay::ObjectPool<Particle>> makeSparsePool(std::size_t count,
+    double aliveFraction) {
+    auto pool = std::make_shared<okay::ObjectPool<Particle>>();
+    std::vector<okay::ObjectPoolHandle> handles;
+    handles.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        handles.push_back(pool->emplace());
+    }
+
+    std::mt19937 rng{42};
+    std::bernoulli_distribution keep(aliveFraction);
+    for (okay::ObjectPoolHandle handle : handles) {
+        if (!keep(rng))
+            pool->destroy(handle);
+    }
+
+    return pool;
+}
+
+void addObjectPoolBenchmarks(Suite& suite) {
+    suite.add("object_pool/emplace_destroy", []() -> RunFn {
+        auto pool = std::make_shared<okay::ObjectPool<Particle>>();
+        return [pool](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                okay::ObjectPoolHandle handle = pool->emplace();
+                doNotOptimize(handle);
+                pool->destroy(handle);
+            }
+        };
+    });
+
+    suite.add("object_pool/emplace_destroy_batch_1k", []() -> RunFn {
+        auto pool = std::make_shared<okay::ObjectPool<Particle>>();
+        auto handles = std::make_shared<std::vector<okay::ObjectPoolHandle>>();
+        handles->reserve(1000);
+        return [pool, handles](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                for (std::size_t j = 0; j < 1000; ++j) {
+                    handles->push_back(pool->emplace());
+                }
+                for (okay::ObjectPoolHandle handle : *handles) {
+                    pool->destroy(handle);
+                }
+                handles->clear();
+            }
+        };
+    });
+
+    for (double alive : {1.0, 0.5, 0.1}) {
+        suite.add(std::format("object_pool/iterate_10k_{}pct_alive", static_cast<int>(alive * 100)),
+            [alive]() -> RunFn {
+                auto pool = makeSparsePool(10000, alive);
+                return [pool](std::size_t iterations) {
+                    for (std::size_t i = 0; i < iterations; ++i) {
+                        for (Particle& particle : *pool) {
+                            particle.position[0] += particle.velocity[0];
+                        }
+                        doNotOptimize(*pool);
+                    }
+                };
+            });
+    }
+}
+
+void addECSBenchmarks(Suite& suite) {
+    suite.add("component_pool/emplace_get_has_10k", []() -> RunFn {
+        auto pool = std::make_shared<okay::ComponentPool<Position>>();
+        pool->reserve(10000);
+        return [pool](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                for (std::size_t index = 0; index < 10000; ++index) {
+                    pool->emplaceAt(index, Position{1.0f, 2.0f, 3.0f});
+                }
+
+                float sum = 0.0f;
+                for (std::size_t index = 0; index < 10000; ++index) {
+                    if (pool->has(index))
+                        sum += pool->get(index).x;
+                }
+                doNotOptimize(sum);
+            }
+        };
+    });
+
+    // every entity has a Position, `matching` percent of them also have a Velocity and are
+    // visited by the query
+    for (int matching : {100, 50, 10}) {
+        suite.add(std::format("ecs/query_10k_{}pct_matching", matching), [matching]() -> RunFn {
+            auto ecs = std::make_shared<okay::ECS>();
+            ecs->registerComponentType<Position>();
+            ecs->registerComponentType<Velocity>();
+
+            std::mt19937 rng{7};
+            std::uniform_int_distribution<int> percent(0, 99);
+            for (std::size_t i = 0; i < 10000; ++i) {
+                okay::ECSEntity entity = ecs->createEntity();
+                entity.addComponent<Position>();
+                if (percent(rng) < matching)
+                    entity.addComponent<Velocity>();
+            }
+
+            return [ecs](std::size_t iterations) {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    for (auto item : ecs->query<okay::query::Get<Position, Velocity>>()) {
+                        Position& position = std::get<0>(item.components);
+                        const Velocity& velocity = std::get<1>(item.components);
+                        position.x += velocity.x;
+                    }
+                    doNotOptimize(*ecs);
+                }
+            };
+        });
+    }
+}
+
+void addEasingBenchmarks(Suite& suite) {
+    const std::pair<const char*, okay::EasingFn> easings[] = {
+        {"linear", okay::easing::linear},
+        {"sine_in_out", okay::easing::sineInOut},
+        {"cubic_in_out", okay::easing::cubicInOut},
+        {"expo_in_out", okay::easing::expoInOut},
+    };
+
+    // goes through EasingFn like the tweens do, one op is 1000 evaluations
+    for (const auto& [name, fn] : easings) {
+        suite.add(std::format("easing/{}_1k", name), [fn]() -> RunFn {
+            return [fn](std::size_t iterations) {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    float sum = 0.0f;
+                    for (int step = 0; step < 1000; ++step) {
+                        sum += fn(static_cast<float>(step) / 1000.0f);
+                    }
+                    doNotOptimize(sum);
+                }
+            };
+        });
+    }
+}
+
+void addSortBenchmarks(Suite& suite) {
+    struct KeyedIndex {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    // keys shaped like render sort keys, a few shaders and materials spread over the high bits
+    auto makeKeys = []() {
+        auto keys = std::make_shared<std::vector<KeyedIndex>>();
+        std::mt19937_64 rng{7};
+        for (std::uint32_t i = 0; i < 50000; ++i) {
+            std::uint64_t shader = rng() % 16;
+            std::uint64_t material = rng() % 512;
+            keys->push_back(KeyedIndex{(shader << 28) | (material << 1), i});
+        }
+        return keys;
+    };
+
+    suite.add("sort/std_sort_50k", [makeKeys]() -> RunFn {
+        auto keys = makeKeys();
+        return [keys](std::size_t iterations) {
+            std::vector<KeyedIndex> items;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                items = *keys;
+                std::sort(items.begin(), items.end(), [](const KeyedIndex& a, const KeyedIndex& b) {
+                    return a.key < b.key;
+                });
+                doNotOptimize(items);
+            }
+        };
+    });
+
+    suite.add("sort/radix_sort_50k", [makeKeys]() -> RunFn {
+        auto keys = makeKeys();
+        return [keys](std::size_t iterations) {
+            std::vector<KeyedIndex> items;
+            std::vector<KeyedIndex> scratch(keys->size());
+            for (std::size_t i = 0; i < iterations; ++i) {
+                items = *keys;
+                okay::radixSort(std::span<KeyedIndex>(items),
+                    std::span<KeyedIndex>(scratch),
+                    [](const KeyedIndex& item) { return item.key; });
+                doNotOptimize(items);
+            }
+        };
+    });
+}
+
+}  // namespace
+
+void registerCoreBenchmarks(Suite& suite) {
+    addObjectPoolBenchmarks(suite);
+    addECSBenchmarks(suite);
+    addEasingBenchmarks(suite);
+    addSortBenchmarks(suite);
+}
+
+}  // namespace microbench
@@ -0,0 +1,294 @@
+#include "microbench.hpp"
+
+#include <okay/core/renderer/command_buffer.hpp>
+#include <okay/core/renderer/materials/unlit.hpp>
+#include <okay/core/renderer/render_world.hpp>
+
+#include <format>
+#include <memory>
+#include <random>
+
+namespace microbench {
+
+namespace {
+
+constexpr std::size_t CHILDREN_PER_ROOT = 4;
+
+struct Hierarchy {
+    okay::RenderWorld world;
+    std::vector<okay::RenderEntity> roots;
+};
+
+// count items split into roots with CHILDREN_PER_ROOT children each, without materials or
+// meshes so the world never touches the gpu
+std::shared_ptr<Hierarchy> makeHierarchy(std::size_t count) {
+    auto hierarchy = std::make_shared<Hierarchy>();
+    okay::RenderWorld& world = hierarchy->world;
+
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> offset(-50.0f, 50.0f);
+
+    std::size_t rootCount = count / (CHILDREN_PER_ROOT + 1);
+    for (std::size_t i = 0; i < rootCount; ++i) {
+        okay::RenderEntity root = world.addRenderEntity(
+            okay::Transform(glm::vec3(offset(rng), offset(rng), offset(rng))),
+            okay::MaterialHandle::none(),
+            okay::Mesh::none());
+        hierarchy->roots.push_back(root);
+
+        for (std::size_t j = 0; j < CHILDREN_PER_ROOT; ++j) {
+            world.addRenderEntity(okay::Transform(glm::vec3(1.0f, 0.0f, 0.0f)),
+                okay::MaterialHandle::none(),
+                okay::Mesh::none(),
+                root);
+        }
+    }
+
+    // settle the initial dirty state so each measured op only pays for its own changes
+    world.drawOrder();
+    return hierarchy;
+}
+
+// scattered unit cubes like the demo scene, settled into the static tree
+std::shared_ptr<okay::RenderWorld> makeScattered(std::size_t count) {
+    auto world = std::make_shared<okay::RenderWorld>();
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<float> offset(-200.0f, 200.0f);
+    okay::Mesh cube(0, 0, 0, 36, okay::Bounds(glm::vec3(-0.5f), glm::vec3(0.5f)));
+    for (std::size_t i = 0; i < count; ++i) {
+        world->addRenderEntity(okay::Transform(glm::vec3(offset(rng), offset(rng), offset(rng))),
+            okay::MaterialHandle::none(),
+            cube);
+    }
+    for (int frame = 0; frame < 128; ++frame) {
+        world->drawOrder();
+    }
+    return world;
+}
+
+okay::Frustum scatteredFrustum() {
+    okay::Camera camera;
+    camera.transform.position = glm::vec3(0.0f, 0.0f, 50.0f);
+    return camera.frustum(16.0f / 9.0f);
+}
+
+void addRenderWorldBenchmarks(Suite& suite) {
+    for (std::size_t count : {1000, 10000, 50000}) {
+        // moves every root, so every item in the world needs a new world matrix
+        suite.add(std::format("render_world/rebuild_transforms_all_{}", count),
+            [count]() -> RunFn {
+                auto hierarchy = makeHierarchy(count);
+                return [hierarchy](std::size_t iterations) {
+                    okay::RenderWorld& world = hierarchy->world;
+                    for (std::size_t i = 0; i < iterations; ++i) {
+                        for (okay::RenderEntity root : hierarchy->roots) {
+                            root->transform.position.x += 0.01f;
+                        }
+                        doNotOptimize(world.drawOrder());
+                    }
+                };
+            });
+    }
+
+    // a handful of moving objects in a large mostly static world, the common case per frame
+    suite.add("render_world/rebuild_transforms_1pct_of_50000", []() -> RunFn {
+        auto hierarchy = makeHierarchy(50000);
+        return [hierarchy](std::size_t iterations) {
+            okay::RenderWorld& world = hierarchy->world;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                for (std::size_t r = 0; r < hierarchy->roots.size(); r += 100) {
+                    hierarchy->roots[r]->transform.position.x += 0.01f;
+                }
+                doNotOptimize(world.drawOrder());
+            }
+        };
+    });
+
+    // the renderer system resubmits every entity each frame, in a static scene none changed
+    suite.add("render_world/update_entities_static_10000", []() -> RunFn {
+        auto hierarchy = makeHierarchy(10000);
+        auto updates = std::make_shared<std::vector<okay::RenderEntityUpdate>>();
+        for (okay::RenderEntity root : hierarchy->roots) {
+            okay::RenderEntity::Properties props = root.prop();
+            updates->push_back(okay::RenderEntityUpdate{.entity = root,
+                .transform = props.transform,
+                .material = props.material,
+                .mesh = props.mesh,
+                .renderLayer = props.renderLayer});
+        }
+
+        return [hierarchy, updates](std::size_t iterations) {
+            okay::RenderWorld& world = hierarchy->world;
+            for (std::size_t i = 0; i < iterations; ++i) {
+                world.updateEntities(*updates);
+                doNotOptimize(world.drawOrder());
+            }
+        };
+    });
+
+    suite.add("render_world/query_frustum_scattered_10000", []() -> RunFn {
+        auto world = makeScattered(10000);
+        okay::Frustum frustum = scatteredFrustum();
+        auto visible = std::make_shared<std::vector<okay::RenderIndex>>();
+        return [world, frustum, visible](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                visible->clear();
+                world->queryFrustum(frustum, *visible);
+                doNotOptimize(*visible);
+            }
+        };
+    });
+
+    // the whole per frame cull, set OKAY_JOB_THREADS=1 to compare against a single thread
+    for (std::size_t count : {10000, 50000}) {
+        suite.add(std::format("render_world/build_draw_list_scattered_{}", count),
+            [count]() -> RunFn {
+                auto world = makeScattered(count);
+                okay::Frustum frustum = scatteredFrustum();
+                auto drawList = std::make_shared<std::vector<okay::RenderSortEntry>>();
+                return [world, frustum, drawList](std::size_t iterations) {
+                    for (std::size_t i = 0; i < iterations; ++i) {
+                        doNotOptimize(world->buildDrawList(frustum, *drawList));
+                    }
+                };
+            });
+    }
+
+    for (std::size_t count : {1000, 10000, 50000}) {
+        // a render layer change forces the sort keys to be recomputed and the items resorted
+        suite.add(std::format("render_world/rebuild_materials_{}", count), [count]() -> RunFn {
+            auto hierarchy = makeHierarchy(count);
+            return [hierarchy](std::size_t iterations) {
+                okay::RenderWorld& world = hierarchy->world;
+                okay::RenderEntity entity = hierarchy->roots.front();
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    entity->renderLayer = static_cast<std::uint8_t>(i & 1);
+                    doNotOptimize(world.drawOrder());
+                }
+            };
+        });
+    }
+}
+
+void addCameraBenchmarks(Suite& suite) {
+    struct FrustumData {
+        okay::Camera camera;
+        std::vector<glm::vec3> points;
+        std::vector<okay::Bounds> bounds;
+        okay::CullBounds cullBounds;
+    };
+
+    auto makeFrustumData = []() {
+        auto data = std::make_shared<FrustumData>();
+        data->camera.transform.position = glm::vec3(0.0f, 0.0f, 20.0f);
+
+        std::mt19937 rng{99};
+        std::uniform_real_distribution<float> coord(-100.0f, 100.0f);
+        std::uniform_real_distribution<float> extent(0.5f, 4.0f);
+        for (std::size_t i = 0; i < 10000; ++i) {
+            glm::vec3 p(coord(rng), coord(rng), coord(rng));
+            data->points.push_back(p);
+            data->bounds.emplace_back(p, p + glm::vec3(extent(rng), extent(rng), extent(rng)));
+            data->cullBounds.push_back(data->bounds.back());
+        }
+        return data;
+    };
+
+    suite.add("camera/is_in_frustum_point_10k", [makeFrustumData]() -> RunFn {
+        auto data = makeFrustumData();
+        return [data](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                std::size_t visible = 0;
+                for (const glm::vec3& p : data->points) {
+                    visible += data->camera.isInFrustum(p, 16.0f / 9.0f);
+                }
+                doNotOptimize(visible);
+            }
+        };
+    });
+
+    suite.add("camera/is_in_frustum_bounds_10k", [makeFrustumData]() -> RunFn {
+        auto data = makeFrustumData();
+        return [data](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                std::size_t visible = 0;
+                for (const okay::Bounds& b : data->bounds) {
+                    visible += data->camera.isInFrustum(b, 16.0f / 9.0f);
+                }
+                doNotOptimize(visible);
+            }
+        };
+    });
+
+    // planes extracted once per frame, tested one box at a time
+    suite.add("camera/frustum_intersects_bounds_10k", [makeFrustumData]() -> RunFn {
+        auto data = makeFrustumData();
+        return [data](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                okay::Frustum frustum = data->camera.frustum(16.0f / 9.0f);
+                std::size_t visible = 0;
+                for (const okay::Bounds& b : data->bounds) {
+                    visible += frustum.intersects(b);
+                }
+                doNotOptimize(visible);
+            }
+        };
+    });
+
+    // what the scene pass does, the batched soa test writing a visible index list
+    suite.add("camera/cull_bounds_soa_10k", [makeFrustumData]() -> RunFn {
+        auto data = makeFrustumData();
+        auto visible = std::make_shared<std::vector<std::uint32_t>>();
+        return [data, visible](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                okay::Frustum frustum = data->camera.frustum(16.0f / 9.0f);
+                visible->clear();
+                okay::cullBounds(frustum, data->cullBounds, *visible);
+                doNotOptimize(*visible);
+            }
+        };
+    });
+}
+
+void addCommandBufferBenchmarks(Suite& suite) {
+    struct CommandData {
+        okay::MaterialRegistry materials;
+        std::vector<okay::MaterialHandle> handles;
+        std::vector<glm::mat4> transforms;
+        okay::RenderCommandBuffer buffer;
+    };
+
+    // what ScenePass records for the demo scene, a few materials over many cubes
+    suite.add("command_buffer/record_draws_10000", []() -> RunFn {
+        auto data = std::make_shared<CommandData>();
+        for (int i = 0; i < 8; ++i) {
+            data->handles.push_back(data->materials.registerMaterial(
+                okay::ShaderHandle{}, std::make_unique<okay::UnlitMaterial>()));
+        }
+        data->transforms.resize(10000, glm::mat4(1.0f));
+        okay::Mesh cube(0, 24, 0, 36, okay::Bounds(glm::vec3(-0.5f), glm::vec3(0.5f)));
+
+        return [data, cube](std::size_t iterations) {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                data->buffer.reset();
+                for (std::size_t d = 0; d < data->transforms.size(); ++d) {
+                    data->buffer.draw(d / 1250,
+                        data->handles[d / 1250],
+                        cube,
+                        data->transforms[d]);
+                }
+                doNotOptimize(data->buffer.commands().data());
+            }
+        };
+    });
+}
+
+}  // namespace
+
+void registerRenderBenchmarks(Suite& suite) {
+    addRenderWorldBenchmarks(suite);
+    addCameraBenchmarks(suite);
+    addCommandBufferBenchmarks(suite);
+}
+
+}  // namespace microbench
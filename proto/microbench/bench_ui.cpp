@@ -0,0 +1,145 @@
+#include "microbench.hpp"
+
+#include <okay/core/asset/asset.hpp>
+#include <okay/core/ui/text_layout.hpp>
+#include <okay/core/ui/text_mesh_builder.hpp>
+#include <okay/core/ui/ui.hpp>
+
+#include <filesystem>
+#include <format>
+#include <memory>
+
+namespace microbench {
+
+namespace {
+
+constexpr std::string_view SHORT_TEXT = "Score: 12345";
+constexpr std::string_view PARAGRAPH_TEXT =
+    "The quick brown fox jumps over the lazy dog.\n"
+    "Pack my box with five dozen liquor jugs.\n"
+    "How vexingly quick daft zebras jump!\n"
+    "Sphinx of black quartz, judge my vow.\n"
+    "The five boxing wizards jump quickly.\n"
+    "Jackdaws love my big sphinx of quartz.\n"
+    "Amazingly few discotheques provide jukeboxes.\n"
+    "Waltz, bad nymph, for quick jigs vex.";
+
+// loads the engine font directly so no asset manager or gpu is needed, none if it's missing
+okay::Option<okay::TextStyle> textStyle() {
+    std::filesystem::path path =
+        std::filesystem::path(OKAY_ENGINE_ASSET_ROOT) / "fonts" / "ARIAL.TTF";
+    if (!std::filesystem::exists(path))
+        return okay::Option<okay::TextStyle>::none();
+
+    auto font = okay::FontManager::instance().loadFont(path.string());
+    if (font.isNone())
+        return okay::Option<okay::TextStyle>::none();
+
+    okay::TextStyle style;
+    style.font = font.value();
+    return okay::Option<okay::TextStyle>::some(style);
+}
+
+// mirrors UI::createNodeFromElement, which is private to the ui system
+okay::UINode makeNode(const okay::UIElement& element, okay::UINode::ID parentID,
+    okay::UINode::ID& nextID) {
+    okay::UINode node;
+    node.id = nextID++;
+    node.parentID = parentID;
+    node.element = element;
+    node.children.reserve(element.children.size());
+    for (const okay::UIElement& child : element.children) {
+        node.children.push_back(makeNode(child, node.id, nextID));
+    }
+    return node;
+}
+
+// rows of fixed or text sized cells, like an inventory or a scoreboard
+okay::UINode makeGrid(std::size_t rows, std::size_t columns, const okay::TextStyle* style) {
+    okay::UIElement root = okay::UIElement{.axis = okay::UIAxis::Vertical}.widthGrow().heightGrow();
+    root.childSpacingSet(okay::size::Fixed{4});
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        okay::UIElement row = okay::UIElement{.axis = okay::UIAxis::Horizontal}.widthGrow();
+        row.childSpacingSet(okay::size::Fixed{4}).paddingSet(okay::size::Fixed{2});
+
+        for (std::size_t c = 0; c < columns; ++c) {
+            okay::UIElement cell;
+            if (style != nullptr) {
+                cell.textSet(std::format("Item {}:{}", r, c)).textStyleSet(*style);
+                cell.widthFit().heightFit();
+            } else {
+                cell.widthSet(okay::size::Fixed{24}).heightSet(okay::size::Fixed{24});
+            }
+            row.addChild(cell);
+        }
+        root.addChild(row);
+    }
+
+    okay::UINode::ID nextID = 1;
+    return makeNode(root, 0, nextID);
+}
+
+RunFn layoutFn(okay::UINode root) {
+    auto layout = std::make_shared<okay::UILayout>(std::move(root));
+    return [layout](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            layout->layout(okay::UILayout::Context{glm::ivec2(1280, 720)});
+            doNotOptimize(*layout);
+        }
+    };
+}
+
+}  // namespace
+
+void registerUIBenchmarks(Suite& suite) {
+    const std::pair<const char*, std::string_view> texts[] = {
+        {"short", SHORT_TEXT},
+        {"paragraph", PARAGRAPH_TEXT},
+    };
+
+    for (const auto& [name, text] : texts) {
+        suite.add(std::format("text_layout/{}", name), [text]() -> RunFn {
+            okay::Option<okay::TextStyle> style = textStyle();
+            if (style.isNone())
+                return {};
+
+            return [text, style = style.value()](std::size_t iterations) {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    okay::TextLayout layout(text, style);
+                    doNotOptimize(layout.metrics());
+                }
+            };
+        });
+
+        suite.add(std::format("text_mesh_builder/{}", name), [text]() -> RunFn {
+            okay::Option<okay::TextStyle> style = textStyle();
+            if (style.isNone())
+                return {};
+
+            auto mesh = std::make_shared<okay::MeshData>();
+            return [text, style = style.value(), mesh](std::size_t iterations) {
+                for (std::size_t i = 0; i < iterations; ++i) {
+                    okay::TextMeshBuilder::build(text, style, false, *mesh);
+                    doNotOptimize(*mesh);
+                }
+            };
+        });
+    }
+
+    suite.add("ui_layout/boxes_1000", []() -> RunFn {
+        return layoutFn(makeGrid(25, 40, nullptr));
+    });
+
+    // fit sized text runs a TextLayout per label and axis, so this mostly measures text metrics
+    suite.add("ui_layout/text_labels_400", []() -> RunFn {
+        okay::Option<okay::TextStyle> style = textStyle();
+        if (style.isNone())
+            return {};
+
+        okay::TextStyle labelStyle = style.value();
+        return layoutFn(makeGrid(20, 20, &labelStyle));
+    });
+}
+
+}  // namespace microbench
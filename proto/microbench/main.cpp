@@ -0,0 +1,82 @@
+#include "microbench.hpp"
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+// okay_microbench, times the engine hot paths that don't need a gl context.
+//
+//   microbench [--filter substring] [--min-ms N] [--repeats N] [--out results.json]
+//   microbench --list
+//
+// The okay cli doesn't forward arguments, so the options can also be given through
+// OKAY_MICROBENCH_FILTER, OKAY_MICROBENCH_MIN_MS, OKAY_MICROBENCH_REPEATS and
+// OKAY_MICROBENCH_OUT. The font and model benchmarks are skipped when the engine assets
+// aren't found relative to the working directory.
+
+namespace {
+
+std::string envOr(const char* name, std::string fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::string(value) : fallback;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    microbench::RunOptions options;
+    options.filter = envOr("OKAY_MICROBENCH_FILTER", "");
+    options.minBatchMs =
+        std::stod(envOr("OKAY_MICROBENCH_MIN_MS", std::to_string(options.minBatchMs)));
+    options.repeats = std::stoi(envOr("OKAY_MICROBENCH_REPEATS", std::to_string(options.repeats)));
+    std::string out = envOr("OKAY_MICROBENCH_OUT", "");
+    bool list = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (arg == "--list") {
+            list = true;
+        } else if (arg == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (arg == "--min-ms" && hasValue) {
+            options.minBatchMs = std::stod(argv[++i]);
+        } else if (arg == "--repeats" && hasValue) {
+            options.repeats = std::stoi(argv[++i]);
+        } else if (arg == "--out" && hasValue) {
+            out = argv[++i];
+        } else {
+            std::cerr << "Unknown argument '" << arg << "'" << std::endl;
+            return 1;
+        }
+    }
+
+    // every benchmark reports statistics over its repeats, there has to be at least one
+    if (options.repeats < 1) {
+        std::cerr << "--repeats must be at least 1, got " << options.repeats << std::endl;
+        return 1;
+    }
+
+    microbench::Suite suite;
+    microbench::registerCoreBenchmarks(suite);
+    microbench::registerRenderBenchmarks(suite);
+    microbench::registerAssetBenchmarks(suite);
+    microbench::registerUIBenchmarks(suite);
+
+    if (list) {
+        suite.list();
+        return 0;
+    }
+
+    std::vector<microbench::Result> results = suite.run(options);
+
+    if (!out.empty()) {
+        std::ofstream file(out);
+        file << microbench::Suite::toJson(results);
+        std::cout << "Wrote " << results.size() << " results to " << out << std::endl;
+    }
+
+    return 0;
+}
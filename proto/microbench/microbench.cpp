@@ -0,0 +1,106 @@
+#include "microbench.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <iostream>
+
+namespace microbench {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double runBatchMs(const RunFn& fn, std::size_t iterations) {
+    Clock::time_point start = Clock::now();
+    fn(iterations);
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+// doubles the iteration count until a batch takes at least minBatchMs
+std::size_t calibrate(const RunFn& fn, double minBatchMs) {
+    std::size_t iterations = 1;
+    while (true) {
+        double ms = runBatchMs(fn, iterations);
+        if (ms >= minBatchMs)
+            return iterations;
+
+        // jump straight to the estimate once a batch is long enough to time reliably
+        if (ms > minBatchMs / 100.0) {
+            return std::max(iterations + 1,
+                static_cast<std::size_t>(static_cast<double>(iterations) * minBatchMs / ms));
+        }
+
+        iterations *= 2;
+    }
+}
+
+}  // namespace
+
+void Suite::add(std::string name, SetupFn setup) {
+    _benchmarks.push_back(Benchmark{std::move(name), std::move(setup)});
+}
+
+void Suite::list() const {
+    for (const Benchmark& benchmark : _benchmarks) {
+        std::cout << benchmark.name << std::endl;
+    }
+}
+
+std::vector<Result> Suite::run(const RunOptions& options) const {
+    std::vector<Result> results;
+
+    std::cout << std::format("{:<48} {:>12} {:>14} {:>14}\n",
+        "benchmark",
+        "iterations",
+        "ns/op (min)",
+        "ns/op (median)");
+
+    for (const Benchmark& benchmark : _benchmarks) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos)
+            continue;
+
+        RunFn fn = benchmark.setup();
+        if (!fn) {
+            std::cout << std::format("{:<48} skipped\n", benchmark.name);
+            continue;
+        }
+
+        std::size_t iterations = calibrate(fn, options.minBatchMs);
+
+        std::vector<double> nsPerOp;
+        for (int i = 0; i < options.repeats; ++i) {
+            nsPerOp.push_back(runBatchMs(fn, iterations) * 1e6 / static_cast<double>(iterations));
+        }
+        std::sort(nsPerOp.begin(), nsPerOp.end());
+
+        Result result{benchmark.name, iterations, nsPerOp.front(), nsPerOp[nsPerOp.size() / 2]};
+        std::cout << std::format("{:<48} {:>12} {:>14.1f} {:>14.1f}\n",
+            result.name,
+            result.iterations,
+            result.nsPerOpMin,
+            result.nsPerOpMedian);
+        results.push_back(std::move(result));
+    }
+
+    return results;
+}
+
+std::string Suite::toJson(const std::vector<Result>& results) {
+    std::string out = "{\n  \"benchmarks\": [";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        out += std::format(
+            "{}\n    {{\"name\": \"{}\", \"iterations\": {}, \"ns_per_op_min\": {:.2f}, "
+            "\"ns_per_op_median\": {:.2f}}}",
+            i == 0 ? "" : ",",
+            result.name,
+            result.iterations,
+            result.nsPerOpMin,
+            result.nsPerOpMedian);
+    }
+    out += "\n  ]\n}\n";
+    return out;
+}
+
+}  // namespace microbench
@@ -0,0 +1,70 @@
+#ifndef __MICROBENCH_H__
+#define __MICROBENCH_H__
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace microbench {
+
+// keeps the compiler from optimizing away a value the benchmark computed
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sink;
+    s_sink = &value;
+#endif
+}
+
+// runs the measured operation `iterations` times
+using RunFn = std::function<void(std::size_t iterations)>;
+
+// builds the benchmark's data and returns the function to measure, only called when the
+// benchmark is selected so expensive setup doesn't slow down filtered runs
+using SetupFn = std::function<RunFn()>;
+
+struct Result {
+    std::string name;
+    std::size_t iterations{0};
+    double nsPerOpMin{0.0};
+    double nsPerOpMedian{0.0};
+};
+
+struct RunOptions {
+    std::string filter;
+    // each repeat runs at least this long, the iteration count is calibrated to it
+    double minBatchMs{50.0};
+    int repeats{5};
+};
+
+class Suite {
+   public:
+    void add(std::string name, SetupFn setup);
+
+    void list() const;
+
+    std::vector<Result> run(const RunOptions& options) const;
+
+    static std::string toJson(const std::vector<Result>& results);
+
+   private:
+    struct Benchmark {
+        std::string name;
+        SetupFn setup;
+    };
+
+    std::vector<Benchmark> _benchmarks;
+};
+
+void registerCoreBenchmarks(Suite& suite);
+void registerRenderBenchmarks(Suite& suite);
+void registerAssetBenchmarks(Suite& suite);
+void registerUIBenchmarks(Suite& suite);
+
+}  // namespace microbench
+
+#endif  // __MICROBENCH_H__